@@ -0,0 +1,95 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "measure.hpp"
+
+#include "percent.hpp"
+#include "urn.hpp"
+
+#include <curl/curl.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using WebDAV::Urn::Path;
+
+int main()
+{
+  curl_global_init(CURL_GLOBAL_ALL);
+
+  const std::vector<std::string> hrefs =
+  {
+    "/remote.php/webdav/projects/2018/reports/summary.pdf",
+    "/remote.php/webdav/photos/holidays/IMG_0042.jpg",
+    "/remote.php/webdav/documents/letter%20to%20the%20editor.odt",
+    "/remote.php/webdav/%D0%B4%D0%BE%D0%BA%D1%83%D0%BC%D0%B5%D0%BD%D1%82%D1%8B/"
+  };
+  const unsigned long long iterations = 1000 * 1000;
+
+  size_t checksum = 0;
+
+  // the legacy listing leaked the result of curl_unescape, it is freed here;
+  // curl allocates with malloc, so its allocations are not counted
+  benchmarks::measure("legacy curl_unescape only", iterations, [&](unsigned long long iteration)
+  {
+    const auto& href = hrefs[iteration % hrefs.size()];
+    auto unescaped = curl_unescape(href.c_str(), static_cast<int>(href.length()));
+    checksum += std::strlen(unescaped);
+    curl_free(unescaped);
+  });
+
+  // the parsed document is writable, a copy of the href stands for it
+  char buffer[256];
+  benchmarks::measure("decode only", iterations, [&](unsigned long long iteration)
+  {
+    const auto& href = hrefs[iteration % hrefs.size()];
+    std::memcpy(buffer, href.data(), href.length());
+    boost::string_view resource_path;
+    WebDAV::Percent::decode(buffer, href.length(), resource_path);
+    checksum += resource_path.length();
+  });
+
+  benchmarks::measure("legacy curl_unescape + path", iterations, [&](unsigned long long iteration)
+  {
+    const auto& href = hrefs[iteration % hrefs.size()];
+    auto unescaped = curl_unescape(href.c_str(), static_cast<int>(href.length()));
+    std::string resource_path = unescaped;
+    curl_free(unescaped);
+    checksum += Path(resource_path).name().length();
+  });
+
+  benchmarks::measure("decode in place + path", iterations, [&](unsigned long long iteration)
+  {
+    const auto& href = hrefs[iteration % hrefs.size()];
+    std::memcpy(buffer, href.data(), href.length());
+    boost::string_view resource_path;
+    if (WebDAV::Percent::decode(buffer, href.length(), resource_path))
+    {
+      checksum += Path(resource_path).name().length();
+    }
+  });
+
+  std::printf("checksum %zu\n", checksum);
+
+  curl_global_cleanup();
+}
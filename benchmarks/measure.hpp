@@ -0,0 +1,74 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_BENCHMARKS_MEASURE_HPP
+#define WEBDAV_BENCHMARKS_MEASURE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// every benchmark is a separate executable, so the global operator new
+// of a benchmark counts all of its heap allocations
+static std::atomic<unsigned long long> allocations_count(0);
+
+void* operator new(size_t size)
+{
+  ++allocations_count;
+  auto pointer = std::malloc(size == 0 ? 1 : size);
+  if (pointer == nullptr) throw std::bad_alloc();
+  return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+namespace benchmarks
+{
+  ///
+  /// Runs a function the given number of times,
+  /// prints time and heap allocations per call
+  ///
+  template <typename Function>
+  auto measure(const char* name, unsigned long long iterations, Function function) -> double
+  {
+    auto start_allocations = allocations_count.load();
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long long iteration = 0; iteration < iterations; ++iteration)
+    {
+      function(iteration);
+    }
+    auto finish = std::chrono::steady_clock::now();
+    auto allocations = allocations_count.load() - start_allocations;
+
+    auto nanoseconds = std::chrono::duration<double, std::nano>(finish - start).count() / iterations;
+    std::printf("%-32s %10.1f ns/call %8.2f allocations/call\n",
+                name, nanoseconds, static_cast<double>(allocations) / iterations);
+    return nanoseconds;
+  }
+} // namespace benchmarks
+
+#endif
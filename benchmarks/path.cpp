@@ -0,0 +1,121 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "measure.hpp"
+
+#include "urn.hpp"
+
+#include <string>
+#include <vector>
+
+using WebDAV::Urn::Path;
+
+// the normalization as it was done before: copies, substr and a find/replace loop
+static auto legacy_normalize(const std::string& path_, bool force_dir) -> std::string
+{
+  std::string path = path_;
+  if (path_.empty()) path = "/";
+  if (path.find("/") != 0) path = "/" + path;
+
+  auto last_symbol = path.substr(path.length() - 1, 1);
+  if (force_dir && last_symbol != "/") path += "/";
+
+  std::string normalized = path;
+  bool is_find = false;
+  do
+  {
+    auto position = normalized.find("//");
+    is_find = position != std::string::npos;
+    if (is_find) normalized.replace(position, 2, "/");
+  }
+  while (is_find);
+  return normalized;
+}
+
+int main()
+{
+  const std::vector<std::string> paths =
+  {
+    "/remote.php/webdav/projects/2018/reports/summary.pdf",
+    "photos/holidays/IMG_0042.jpg",
+    "/documents//drafts/",
+    "backups/db-dump.sql.gz"
+  };
+  const std::string pathological = "/" + std::string(256, '/') + "file";
+  const Path root_urn("/remote.php/webdav", true);
+  const unsigned long long iterations = 1000 * 1000;
+
+  size_t checksum = 0;
+
+  benchmarks::measure("legacy normalize", iterations, [&](unsigned long long iteration)
+  {
+    checksum += legacy_normalize(paths[iteration % paths.size()], false).length();
+  });
+
+  benchmarks::measure("construct", iterations, [&](unsigned long long iteration)
+  {
+    Path path(paths[iteration % paths.size()]);
+    checksum += path.length();
+  });
+
+  benchmarks::measure("legacy normalize separators", iterations / 100, [&](unsigned long long)
+  {
+    checksum += legacy_normalize(pathological, false).length();
+  });
+
+  benchmarks::measure("construct separators", iterations / 100, [&](unsigned long long)
+  {
+    Path path(pathological);
+    checksum += path.length();
+  });
+
+  benchmarks::measure("append", iterations, [&](unsigned long long iteration)
+  {
+    auto path = root_urn + paths[iteration % paths.size()];
+    checksum += path.hash();
+  });
+
+  std::vector<Path> urns;
+  for (const auto& path : paths) urns.push_back(root_urn + path);
+
+  benchmarks::measure("name", iterations, [&](unsigned long long iteration)
+  {
+    checksum += urns[iteration % urns.size()].name().length();
+  });
+
+  benchmarks::measure("name view", iterations, [&](unsigned long long iteration)
+  {
+    checksum += urns[iteration % urns.size()].name_view().length();
+  });
+
+  benchmarks::measure("parent", iterations, [&](unsigned long long iteration)
+  {
+    checksum += urns[iteration % urns.size()].parent().length();
+  });
+
+  benchmarks::measure("compare", iterations, [&](unsigned long long iteration)
+  {
+    checksum += urns[iteration % urns.size()] == urns[(iteration + 1) % urns.size()] ? 1 : 0;
+  });
+
+  std::printf("checksum %zu\n", checksum);
+}
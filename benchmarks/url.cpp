@@ -0,0 +1,101 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "measure.hpp"
+
+#include "urn.hpp"
+
+#include <curl/curl.h>
+
+#include <string>
+#include <vector>
+
+using WebDAV::Urn::Path;
+
+// the quoting as it was done before: split into names, escape every name
+static auto legacy_quote(void* request, const std::string& path) -> std::string
+{
+  std::vector<std::string> names;
+  auto start = path.find_first_not_of('/');
+  while (start != std::string::npos)
+  {
+    auto end = path.find('/', start);
+    names.push_back(path.substr(start, end == std::string::npos ? std::string::npos : end - start));
+    start = path.find_first_not_of('/', end);
+  }
+
+  std::string quote_path;
+  for (const auto& name : names)
+  {
+    auto escape_name = curl_easy_escape(request, name.c_str(), static_cast<int>(name.length()));
+    quote_path.append("/");
+    quote_path.append(escape_name);
+    curl_free(escape_name);
+  }
+  if (path.back() == '/') quote_path.append("/");
+  return quote_path;
+}
+
+int main()
+{
+  curl_global_init(CURL_GLOBAL_ALL);
+  auto request = curl_easy_init();
+
+  const std::string hostname = "https://webdav.example.com";
+  const Path root_urn("/remote.php/webdav", true);
+  const std::vector<std::string> resources =
+  {
+    "projects/2018/reports/summary.pdf",
+    "photos/holidays/IMG_0042.jpg",
+    "documents/letter to the editor.odt",
+    "backups/db-dump.sql.gz",
+    "документы/отчёт за 2018 год.docx"
+  };
+  const unsigned long long iterations = 1000 * 1000;
+
+  std::vector<Path> resource_urns;
+  for (const auto& resource : resources) resource_urns.push_back(root_urn + resource);
+
+  size_t checksum = 0;
+
+  benchmarks::measure("legacy hostname + quote", iterations, [&](unsigned long long iteration)
+  {
+    const auto& resource_urn = resource_urns[iteration % resource_urns.size()];
+    auto url = hostname + legacy_quote(request, resource_urn.path());
+    checksum += url.length();
+  });
+
+  benchmarks::measure("quote in place", iterations, [&](unsigned long long iteration)
+  {
+    const auto& resource_urn = resource_urns[iteration % resource_urns.size()];
+    std::string url;
+    url.reserve(hostname.length() + resource_urn.length() + 1);
+    url.append(hostname);
+    resource_urn.quote(url);
+    checksum += url.length();
+  });
+
+  std::printf("checksum %zu\n", checksum);
+
+  curl_easy_cleanup(request);
+  curl_global_cleanup();
+}
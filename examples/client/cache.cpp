@@ -0,0 +1,61 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include <webdav/client.hpp>
+
+#include <iostream>
+#include <memory>
+
+//! [invalidate]
+
+void invalidate()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"},
+    {"cache_ttl", "5000"},
+    {"cache_capacity", "100000"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_file = "dir/file.dat";
+  client->check(remote_file);
+  client->check(remote_file); // answered from the cache
+
+  // the resource was changed by another client
+  client->invalidate("dir");
+
+  bool is_existed = client->check(remote_file);
+  std::cout << remote_file << " resource is " << (is_existed ? "" : "not ") << "existed" << std::endl;
+}
+
+/// dir/file.dat resource is existed
+
+//! [invalidate]
+
+int main()
+{
+  invalidate();
+}
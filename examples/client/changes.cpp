@@ -0,0 +1,74 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include <webdav/client.hpp>
+
+#include <iostream>
+#include <memory>
+
+int main()
+{
+  auto hostname_ptr = std::getenv("WEBDAV_HOSTNAME");
+  auto username_ptr = std::getenv("WEBDAV_USERNAME");
+  auto password_ptr = std::getenv("WEBDAV_PASSWORD");
+  auto root_ptr = std::getenv("WEBDAV_ROOT");
+
+  if (hostname_ptr == nullptr) return -1;
+  if (username_ptr == nullptr) return -1;
+  if (password_ptr == nullptr) return -1;
+
+  std::map<std::string, std::string> options =
+  {
+    { "webdav_hostname", hostname_ptr },
+    { "webdav_username", username_ptr },
+    { "webdav_password", password_ptr }
+  };
+
+  if (root_ptr != nullptr)
+  {
+    options["webdav_root"] = root_ptr;
+  }
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  // the first call lists everything and returns the token for the next one
+  std::string sync_token;
+  std::map<std::string, std::map<std::string, std::string>> changed;
+  std::vector<std::string> removed;
+  if (!client->changes("existing_directory", sync_token, changed, removed)) return -1;
+
+  client->upload("existing_directory/file.dat", "file.dat");
+  client->clean("existing_directory/dir/");
+
+  if (!client->changes("existing_directory", sync_token, changed, removed)) return -1;
+  for (const auto& resource : changed)
+  {
+    std::cout << resource.first << " is changed, its ETag is " << resource.second.at("etag") << std::endl;
+  }
+  for (const auto& resource : removed)
+  {
+    std::cout << resource << " is removed" << std::endl;
+  }
+}
+
+/// file.dat is changed, its ETag is "5b2b1d8a-1000"
+/// dir/ is removed
@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <fstream>
+#include <vector>
 
 //! [download_to_file]
 
@@ -49,6 +50,33 @@ void download_to_file()
 
 //! [download_to_file]
 
+//! [download_if_modified]
+
+void download_if_modified()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_file = "dir/file.dat";
+  auto local_file = "/home/user/Downloads/file.dat";
+
+  // the second call is answered with 304 Not Modified and keeps the local file
+  client->download_if_modified(remote_file, local_file);
+  bool is_up_to_date = client->download_if_modified(remote_file, local_file);
+
+  std::cout << local_file << " file is " << (is_up_to_date ? "" : "not ") << "up to date" << std::endl;
+}
+
+/// /home/user/Downloads/file.dat file is up to date
+
+//! [download_if_modified]
+
 //! [async_download_to_file]
 
 void async_download_to_file()
@@ -101,6 +129,93 @@ void download_to_buffer()
 
 //! [download_to_buffer]
 
+//! [download_into_buffer]
+
+void download_into_buffer()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_file = "dir/file.dat";
+  char buffer[4096];
+  unsigned long long buffer_size = 0;
+
+  // a file which does not fit into the buffer is not downloaded
+  bool is_downloaded = client->download_into(remote_file, buffer, sizeof(buffer), buffer_size);
+
+  std::cout << remote_file << " resource is" << (is_downloaded ? "" : "not") << "downloaded" << std::endl;
+}
+
+/// dir/file.dat resource is downloaded
+
+//! [download_into_buffer]
+
+//! [download_to_vector]
+
+void download_to_vector()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  // the capacity of the buffer is reused by the following downloads
+  std::vector<char> buffer;
+  for (auto remote_file : { "dir/file1.dat", "dir/file2.dat" })
+  {
+    bool is_downloaded = client->download_to(remote_file, buffer);
+    std::cout << remote_file << " resource is" << (is_downloaded ? "" : "not") << "downloaded" << std::endl;
+  }
+}
+
+/// dir/file1.dat resource is downloaded
+/// dir/file2.dat resource is downloaded
+
+//! [download_to_vector]
+
+//! [download_tree]
+
+void download_tree()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_directory = "dir";
+  std::string local_directory = "/home/user/Downloads/dir";
+
+  // eight files are downloaded at once, the progress is reported for the whole tree
+  bool is_downloaded = client->download_tree(remote_directory, local_directory, 8, [](const WebDAV::TreeProgress & progress)
+  {
+    std::cout << progress.files_done << "/" << progress.files_count << " files, "
+              << progress.bytes_now << " bytes" << std::endl;
+    return true;
+  });
+
+  std::cout << remote_directory << " directory is " << (is_downloaded ? "" : "not ") << "downloaded" << std::endl;
+}
+
+/// 1/2 files, 1024 bytes
+/// 2/2 files, 2048 bytes
+/// dir directory is downloaded
+
+//! [download_tree]
+
 //! [async_download_to_buffer]
 
 void async_download_to_buffer()
@@ -155,11 +270,74 @@ void download_from_stream()
 
 //! [download_from_stream]
 
+//! [open_remote_file]
+
+void open_remote_file()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_file = "dir/archive.zip";
+  auto file = client->open(remote_file);
+  if (!file.is_open()) return;
+
+  // the end of central directory record of a ZIP archive
+  char record[22];
+  auto read_bytes = file.pread(record, sizeof(record), file.size() - sizeof(record));
+
+  std::cout << remote_file << " tail of " << read_bytes << " bytes is read" << std::endl;
+}
+
+/// dir/archive.zip tail of 22 bytes is read
+
+//! [open_remote_file]
+
+//! [open_remote_stream]
+
+void open_remote_stream()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_file = "dir/file.dat";
+  auto stream = client->open_stream(remote_file);
+
+  // no more than 64 KiB of the file are kept in memory at once
+  std::string line;
+  size_t lines_count = 0;
+  while (std::getline(stream, line)) ++lines_count;
+
+  if (stream.bad()) return;
+  std::cout << remote_file << " has " << lines_count << " lines" << std::endl;
+}
+
+/// dir/file.dat has 12 lines
+
+//! [open_remote_stream]
+
 int main()
 {
   download_to_file();
+  download_if_modified();
   download_to_buffer();
+  download_into_buffer();
+  download_to_vector();
+  download_tree();
   async_download_to_file();
   async_download_to_buffer();
   download_from_stream();
+  open_remote_file();
+  open_remote_stream();
 }
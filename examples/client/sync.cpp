@@ -0,0 +1,67 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include <webdav/client.hpp>
+
+#include <iostream>
+#include <memory>
+
+//! [sync]
+
+void sync_directories()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_directory = "documents";
+  std::string local_directory = "/home/user/Documents";
+
+  // a dry run only tells what would be done
+  WebDAV::SyncPlan plan;
+  client->sync(remote_directory, local_directory, plan, true);
+  std::cout << plan.actions.size() << " actions: " << plan.upload_size << " bytes up, "
+            << plan.download_size << " bytes down, " << plan.requests << " requests" << std::endl;
+
+  bool is_synchronized = client->sync(remote_directory, local_directory, plan);
+  for (const auto& action : plan.actions)
+  {
+    if (action.kind == WebDAV::SyncAction::conflict) std::cout << action.path << " has changed on both sides" << std::endl;
+  }
+
+  std::cout << local_directory << " directory is " << (is_synchronized ? "" : "not ") << "synchronized" << std::endl;
+}
+
+/// 3 actions: 1048576 bytes up, 4096 bytes down, 3 requests
+/// /home/user/Documents directory is synchronized
+
+//! [sync]
+
+int main()
+{
+  sync_directories();
+}
@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <fstream>
+#include <vector>
 
 //! [upload_from_file]
 
@@ -155,11 +156,110 @@ void upload_from_stream()
 
 //! [upload_from_stream]
 
+//! [open_remote_writer]
+
+void open_remote_writer()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_file = "dir/numbers.txt";
+  auto writer = client->open_writer(remote_file);
+
+  // the size of generated data is not known beforehand
+  for (int number = 0; number < 1000 * 1000; ++number)
+  {
+    writer << number << std::endl;
+  }
+
+  bool is_uploaded = writer.close();
+
+  std::cout << remote_file << " resource is" << (is_uploaded ? "" : "not") << "uploaded" << std::endl;
+}
+
+/// dir/numbers.txt resource is uploaded
+
+//! [open_remote_writer]
+
+//! [upload_from_segments]
+
+void upload_from_segments()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string header = "header\n";
+  std::vector<char> block(1024, 'x');
+  std::string trailer = "trailer\n";
+
+  WebDAV::segments_t segments =
+  {
+    { header.data(), header.size() },
+    { block.data(), block.size() },
+    { trailer.data(), trailer.size() }
+  };
+
+  std::string remote_file = "dir/file.dat";
+  bool is_uploaded = client->upload_from(remote_file, segments);
+
+  std::cout << remote_file << " resource is" << (is_uploaded ? "" : "not") << "uploaded" << std::endl;
+}
+
+/// dir/file.dat resource is uploaded
+
+//! [upload_from_segments]
+
+//! [upload_tree]
+
+void upload_tree()
+{
+  std::map<std::string, std::string> options =
+  {
+    {"webdav_hostname", "https://webdav.yandex.ru"},
+    {"webdav_username", "{webdav_username}"},
+    {"webdav_password", "{webdav_password}"}
+  };
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  std::string remote_directory = "backup/photos";
+  std::string local_directory = "/home/user/Pictures";
+
+  // the files of a directory are uploaded right after the directory is created
+  bool is_uploaded = client->upload_tree(remote_directory, local_directory, 8, [](const WebDAV::TreeProgress & progress)
+  {
+    std::cout << progress.file << ": " << progress.file_now << "/" << progress.file_total << " bytes" << std::endl;
+    return true;
+  });
+
+  std::cout << local_directory << " directory is " << (is_uploaded ? "" : "not ") << "uploaded" << std::endl;
+}
+
+/// backup/photos/2018/beach.jpg: 1048576/1048576 bytes
+/// /home/user/Pictures directory is uploaded
+
+//! [upload_tree]
+
 int main()
 {
   upload_from_file();
   upload_from_buffer();
   upload_from_stream();
+  open_remote_writer();
+  upload_from_segments();
+  upload_tree();
   async_upload_from_file();
   async_upload_from_buffer();
 }
@@ -26,7 +26,9 @@
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace WebDAV
@@ -42,6 +44,195 @@ namespace WebDAV
   using strings_t = std::vector<std::string>;
   using dict_t = std::map<std::string, std::string>;
 
+  using segment_t = std::pair<const char*, size_t>;
+  using segments_t = std::vector<segment_t>;
+
+  ///
+  /// Progress of a transfer of a directory tree: the file which has progressed
+  /// and the totals of the whole tree
+  ///
+  struct TreeProgress
+  {
+    std::string file;
+    unsigned long long file_now;
+    unsigned long long file_total;
+    unsigned long long bytes_now;
+    size_t files_done;
+    size_t files_failed;
+    size_t files_count;
+  };
+
+  ///
+  /// The transfer of a tree is cancelled once the function returns false
+  ///
+  using tree_progress_t = std::function<bool(const TreeProgress& progress)>;
+
+  ///
+  /// A step of a synchronization, paths are relative to the synchronized directories
+  ///
+  struct SyncAction
+  {
+    enum Kind
+    {
+      upload,
+      download,
+      create_remote_directory,
+      create_local_directory,
+      remove_remote,
+      remove_local,
+      move_remote,
+      move_local,
+      compare,  ///< a file on both sides without a record: the same content is synchronized, another one conflicts
+      conflict
+    };
+
+    Kind kind;
+    std::string path;
+    std::string destination;  ///< new path of a moved file
+    unsigned long long size;  ///< bytes to transfer
+    bool is_directory;
+    bool is_done;
+  };
+
+  ///
+  /// The actions which synchronize two directories and what they cost.
+  /// A conflict is reported and left as it is on both sides
+  ///
+  struct SyncPlan
+  {
+    std::vector<SyncAction> actions;
+    unsigned long long upload_size;
+    unsigned long long download_size;
+    size_t requests;       ///< requests which perform the actions
+    size_t scan_requests;  ///< requests which listed the remote directory
+    size_t conflicts;
+  };
+
+  class Cache;
+  struct Config;
+  class Directories;
+  struct Flights;
+  class Prefetcher;
+  class Reader;
+  class Fetcher;
+  class Sender;
+  class Connection;
+  struct TreeTransfer;
+
+  namespace Sync
+  {
+    struct Session;
+  }
+
+  namespace Urn
+  {
+    class Path;
+  }
+
+  ///
+  /// \brief Random access to a remote file
+  ///
+  /// Reads are served from a cache of fixed-size blocks which are fetched
+  /// with Range requests, sequential reads grow a read-ahead window.
+  /// Reads fail once the remote file is changed.
+  ///
+  class RemoteFile
+  {
+  public:
+    RemoteFile(RemoteFile&& other) noexcept;
+    ~RemoteFile();
+
+    RemoteFile(const RemoteFile& other) = delete;
+    auto operator=(const RemoteFile& other) -> RemoteFile& = delete;
+    auto operator=(RemoteFile&& other) noexcept -> RemoteFile&;
+
+    ///
+    /// Checks whether the remote file was opened
+    ///
+    auto is_open() const -> bool;
+
+    ///
+    /// Get size of the remote file
+    /// \return size in bytes
+    ///
+    auto size() const -> unsigned long long;
+
+    ///
+    /// Read a part of the remote file
+    /// \param[out] buffer
+    /// \param[in] length
+    /// \param[in] offset
+    /// \return number of read bytes, 0 at the end of the file or -1 on failure
+    ///
+    auto pread(char* buffer, size_t length, unsigned long long offset) const -> long long;
+
+  private:
+    friend class Client;
+    explicit RemoteFile(std::unique_ptr<Reader> reader);
+
+    std::unique_ptr<Reader> reader;
+  };
+
+  ///
+  /// \brief Sequential read of a remote file while it is downloaded
+  ///
+  /// The content is pulled through a buffer of a fixed size, the download
+  /// is paused until the buffer is drained, so a slow reader keeps
+  /// the memory bounded. A failed download ends the stream and sets badbit,
+  /// also for a reader of the stream buffer.
+  ///
+  class RemoteStream : public std::istream
+  {
+  public:
+    RemoteStream(RemoteStream&& other) noexcept;
+    ~RemoteStream();
+
+    RemoteStream(const RemoteStream& other) = delete;
+    auto operator=(const RemoteStream& other) -> RemoteStream& = delete;
+    auto operator=(RemoteStream&& other) noexcept -> RemoteStream&;
+
+    ///
+    /// \return HTTP status of the response, 0 until it is received
+    ///
+    auto status() const -> long;
+
+  private:
+    friend class Client;
+    explicit RemoteStream(std::unique_ptr<Fetcher> fetcher);
+
+    std::unique_ptr<Fetcher> fetcher;
+  };
+
+  ///
+  /// \brief Sequential write of a remote file while it is uploaded
+  ///
+  /// The content is pushed through a buffer of a fixed size, a writer waits
+  /// until the upload has taken the whole buffer. The upload is committed
+  /// by close, a destroyed writer which was not closed aborts the upload.
+  ///
+  class RemoteWriter : public std::ostream
+  {
+  public:
+    RemoteWriter(RemoteWriter&& other) noexcept;
+    ~RemoteWriter();
+
+    RemoteWriter(const RemoteWriter& other) = delete;
+    auto operator=(const RemoteWriter& other) -> RemoteWriter& = delete;
+    auto operator=(RemoteWriter&& other) noexcept -> RemoteWriter&;
+
+    ///
+    /// Send the rest of the buffer and finish the upload
+    /// \return true if the upload is completed
+    ///
+    auto close() -> bool;
+
+  private:
+    friend class Client;
+    explicit RemoteWriter(std::unique_ptr<Sender> sender);
+
+    std::unique_ptr<Sender> sender;
+  };
+
   ///
   /// \brief WebDAV Client
   /// \author designerror
@@ -62,6 +253,16 @@ namespace WebDAV
     /// \param[in] proxy_password
     /// \param[in] cert_path
     /// \param[in] key_path
+    /// \param[in] cache_ttl time to live of cached metadata in milliseconds, 0 disables the cache
+    /// \param[in] negative_cache_ttl time to live of cached absence of resources in milliseconds
+    /// \param[in] cache_capacity maximum number of cached resources
+    /// \param[in] directory_cache_ttl time to live of remote directories known to exist in milliseconds,
+    ///            0 disables remembering them
+    /// \param[in] prefetch_count number of small files downloaded in background after a listing, requires the cache
+    /// \param[in] prefetch_size_limit maximum size of a prefetched file in bytes, no more than prefetch_capacity
+    /// \param[in] prefetch_capacity maximum size of all prefetched files in bytes
+    /// \param[in] recursive_etags 1 if the ETag of a directory changes with anything beneath it,
+    ///            so that sync skips the unchanged directories like it does by getctag
     /// \include client/init.cpp
     ///
     explicit Client(const dict_t& options);
@@ -108,9 +309,32 @@ namespace WebDAV
     auto list(const std::string& remote_directory = "") const -> strings_t;
 
     ///
-    /// Create a remote directory
+    /// List the resources beneath a remote directory which have changed since the token
+    /// was issued, with the sync-collection report (RFC 6578). An empty token lists all of them,
+    /// so that the following calls cost as much as the number of changes, not of resources
     /// \param[in] remote_directory
-    /// \param[in] recursive
+    /// \param[in,out] sync_token the token of the previous call, the new token on return
+    /// \param[out] changed information of the added and changed resources by their paths
+    ///             relative to the directory, the paths of directories end with a separator
+    /// \param[out] removed paths of the removed resources
+    /// \return false if the server does not report changes or the token has expired,
+    ///         the token is cleared then
+    /// \include client/changes.cpp
+    ///
+    auto changes(
+      const std::string& remote_directory,
+      std::string& sync_token,
+      std::map<std::string, dict_t>& changed,
+      strings_t& removed
+    ) const -> bool;
+
+    ///
+    /// Create a remote directory. With directory_cache_ttl set, directories
+    /// created or found by the client are remembered for that time, so creating
+    /// them again costs no request and creating their subdirectories one.
+    /// \param[in] remote_directory
+    /// \param[in] recursive create missing parent directories too
+    /// \return true if the directory is created or exists
     /// \include client/mkdir.cpp
     ///
     auto create_directory(
@@ -153,6 +377,53 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const -> bool;
 
+    ///
+    /// Download a remote file to a local file and get its information
+    /// from the response headers
+    /// \param[in] remote_file
+    /// \param[in] local_file
+    /// \param[out] information etag, modified, size and content_type of the file
+    /// \param[in] progress
+    ///
+    auto download(
+      const std::string& remote_file,
+      const std::string& local_file,
+      dict_t& information,
+      progress_t progress = nullptr
+    ) const -> bool;
+
+    ///
+    /// Download a remote file to a local file unless it is not modified
+    /// since the previous download. The validators of the previous download
+    /// are kept beside the local file in a sidecar file with the .etag suffix.
+    /// \param[in] remote_file
+    /// \param[in] local_file
+    /// \param[in] progress
+    /// \return true if the local file is up to date
+    /// \snippet client/download.cpp download_if_modified
+    ///
+    auto download_if_modified(
+      const std::string& remote_file,
+      const std::string& local_file,
+      progress_t progress = nullptr
+    ) const -> bool;
+
+    ///
+    /// Download a remote file to a local file unless it is not modified
+    /// since the previous download
+    /// \param[in] remote_file
+    /// \param[in] local_file
+    /// \param[in,out] validators etag and modified of the previous download
+    /// \param[in] progress
+    /// \return true if the local file is up to date
+    ///
+    auto download_if_modified(
+      const std::string& remote_file,
+      const std::string& local_file,
+      dict_t& validators,
+      progress_t progress = nullptr
+    ) const -> bool;
+
     ///
     /// Download a remote file to a buffer
     /// \param[in] remote_file
@@ -168,6 +439,49 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const -> bool;
 
+    ///
+    /// Download a remote file to a buffer of the caller
+    /// \param[in] remote_file
+    /// \param[out] buffer_ptr
+    /// \param[in] buffer_capacity
+    /// \param[out] buffer_size
+    /// \param[in] progress
+    /// \return false if the file does not fit into the buffer
+    /// \snippet client/download.cpp download_into_buffer
+    ///
+    auto download_into(
+      const std::string& remote_file,
+      char* buffer_ptr,
+      unsigned long long buffer_capacity,
+      unsigned long long& buffer_size,
+      progress_t progress = nullptr
+    ) const -> bool;
+
+    ///
+    /// Download a remote file to a vector, its capacity is reused
+    /// \param[in] remote_file
+    /// \param[out] buffer
+    /// \param[in] progress
+    /// \snippet client/download.cpp download_to_vector
+    ///
+    auto download_to(
+      const std::string& remote_file,
+      std::vector<char>& buffer,
+      progress_t progress = nullptr
+    ) const -> bool;
+
+    ///
+    /// Download a remote file to a string, its capacity is reused
+    /// \param[in] remote_file
+    /// \param[out] buffer
+    /// \param[in] progress
+    ///
+    auto download_to(
+      const std::string& remote_file,
+      std::string& buffer,
+      progress_t progress = nullptr
+    ) const -> bool;
+
     ///
     /// Download a remote file to a stream
     /// \param[in] remote_file
@@ -196,6 +510,24 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const -> void;
 
+    ///
+    /// Download a remote directory with all its subdirectories to a local directory.
+    /// Files are downloaded by several threads which reuse connections,
+    /// every file is written to a temporary file and renamed when it is complete.
+    /// \param[in] remote_directory
+    /// \param[in] local_directory
+    /// \param[in] parallelism maximum number of files downloaded at once
+    /// \param[in] progress
+    /// \return true if all directories are listed and all files are downloaded
+    /// \snippet client/download.cpp download_tree
+    ///
+    auto download_tree(
+      const std::string& remote_directory,
+      const std::string& local_directory,
+      size_t parallelism = 4,
+      tree_progress_t progress = nullptr
+    ) const -> bool;
+
     ///
     /// Upload a remote file from a local file
     /// \param[in] remote_file
@@ -209,6 +541,21 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const -> bool;
 
+    ///
+    /// Upload a remote file from a local file and get its new information
+    /// from the response headers
+    /// \param[in] remote_file
+    /// \param[in] local_file
+    /// \param[out] information etag, modified and size of the file
+    /// \param[in] progress
+    ///
+    auto upload(
+      const std::string& remote_file,
+      const std::string& local_file,
+      dict_t& information,
+      progress_t progress = nullptr
+    ) const -> bool;
+
     ///
     /// Upload a remote file from a buffer
     /// \param[in] remote_file
@@ -224,6 +571,19 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const -> bool;
 
+    ///
+    /// Upload a remote file from a sequence of buffers without joining them
+    /// \param[in] remote_file
+    /// \param[in] segments pointers and sizes of the buffers, which must live until the upload is finished
+    /// \param[in] progress
+    /// \snippet client/upload.cpp upload_from_segments
+    ///
+    auto upload_from(
+      const std::string& remote_file,
+      const segments_t& segments,
+      progress_t progress = nullptr
+    ) const -> bool;
+
     ///
     /// Upload a remote file from a stream
     /// \param[in] remote_file
@@ -237,6 +597,55 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const -> bool;
 
+    ///
+    /// Upload a local directory with all its subdirectories to a remote directory.
+    /// Every remote directory is created once, before the files it contains,
+    /// files are uploaded by several threads which reuse connections
+    /// as soon as their directory exists.
+    /// \param[in] remote_directory
+    /// \param[in] local_directory
+    /// \param[in] parallelism maximum number of requests performed at once
+    /// \param[in] progress
+    /// \return true if all files are uploaded
+    /// \snippet client/upload.cpp upload_tree
+    ///
+    auto upload_tree(
+      const std::string& remote_directory,
+      const std::string& local_directory,
+      size_t parallelism = 4,
+      tree_progress_t progress = nullptr
+    ) const -> bool;
+
+    ///
+    /// Synchronize a remote directory and a local directory in both directions.
+    /// Both sides are compared with their states after the last synchronization,
+    /// which are kept in the local directory: what has changed on one side
+    /// is uploaded, downloaded, created, removed or moved on the other,
+    /// what has changed on both sides is a conflict and stays untouched.
+    /// A file which changes while it is synchronized turns into a conflict too.
+    /// The actions are performed by several threads which reuse connections.
+    /// The remote directory is listed by its changes since the last synchronization
+    /// if the server reports them, otherwise the directories whose getctag
+    /// is the same as last time are not listed again.
+    /// \param[in] remote_directory
+    /// \param[in] local_directory
+    /// \param[out] plan the actions with their results and their costs
+    /// \param[in] is_dry_run only plan the actions
+    /// \param[in] parallelism maximum number of requests performed at once
+    /// \param[in] progress
+    /// \return true if all actions are done and there are no conflicts,
+    ///         for a dry run true if both directories are listed
+    /// \snippet client/sync.cpp sync
+    ///
+    auto sync(
+      const std::string& remote_directory,
+      const std::string& local_directory,
+      SyncPlan& plan,
+      bool is_dry_run = false,
+      size_t parallelism = 4,
+      tree_progress_t progress = nullptr
+    ) const -> bool;
+
     ///
     /// Asynchronously upload a remote file from a local file
     /// \param[in] remote_file
@@ -252,12 +661,76 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const -> void;
 
+    ///
+    /// Drop cached metadata of a remote resource and all resources beneath it
+    /// \param[in] remote_resource
+    /// \snippet client/cache.cpp invalidate
+    ///
+    auto invalidate(const std::string& remote_resource = "/") const -> void;
+
+    ///
+    /// Read the client certificate and its key again, e.g. after a rotation.
+    /// The files may also appear after the client is constructed.
+    /// The following requests of the client and all its copies use them.
+    /// \return false if there is no client certificate or it can not be read,
+    ///         the previous certificate is used then
+    ///
+    auto reload_certificate() const -> bool;
+
+    ///
+    /// Open a remote file for random access.
+    /// A server without range support sends the whole file at once,
+    /// so such a file is read only if it fits into the cache
+    /// \param[in] remote_file
+    /// \param[in] block_size size of a fetched block in bytes
+    /// \param[in] cache_size number of cached blocks
+    /// \snippet client/download.cpp open_remote_file
+    ///
+    auto open(
+      const std::string& remote_file,
+      size_t block_size = 64 * 1024,
+      size_t cache_size = 64
+    ) const -> RemoteFile;
+
+    ///
+    /// Open a remote file for sequential read while it is downloaded
+    /// \param[in] remote_file
+    /// \param[in] buffer_size size of the buffer between the download and the reader in bytes
+    /// \snippet client/download.cpp open_remote_stream
+    ///
+    auto open_stream(
+      const std::string& remote_file,
+      size_t buffer_size = 64 * 1024
+    ) const -> RemoteStream;
+
+    ///
+    /// Open a remote file for sequential write while it is uploaded.
+    /// Data of an unknown size are sent with the chunked transfer encoding.
+    /// \param[in] remote_file
+    /// \param[in] file_size size of the whole file in bytes if it is known, otherwise -1
+    /// \param[in] buffer_size size of the buffer between the writer and the upload in bytes
+    /// \snippet client/upload.cpp open_remote_writer
+    ///
+    auto open_writer(
+      const std::string& remote_file,
+      long long file_size = -1,
+      size_t buffer_size = 64 * 1024
+    ) const -> RemoteWriter;
+
   private:
 
     auto sync_download(
       const std::string& remote_file,
       const std::string& local_file,
       callback_t callback = nullptr,
+      progress_t progress = nullptr,
+      dict_t* information = nullptr
+    ) const -> bool;
+
+    auto sync_download_if_modified(
+      const std::string& remote_file,
+      const std::string& local_file,
+      dict_t& validators,
       progress_t progress = nullptr
     ) const -> bool;
 
@@ -276,11 +749,19 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const ;
 
+    template <typename Container>
+    auto sync_download_to(
+      const std::string& remote_file,
+      Container& container,
+      progress_t progress = nullptr
+    ) const -> bool;
+
     bool sync_upload(
       const std::string& remote_file,
       const std::string& local_file,
       callback_t callback = nullptr,
-      progress_t progress = nullptr
+      progress_t progress = nullptr,
+      dict_t* information = nullptr
     ) const ;
 
     auto sync_upload_from(
@@ -298,21 +779,54 @@ namespace WebDAV
       progress_t progress = nullptr
     ) const -> bool;
 
+    auto sync_upload_from(
+      const std::string& remote_file,
+      const segments_t& segments,
+      callback_t callback = nullptr,
+      progress_t progress = nullptr
+    ) const -> bool;
+
+    auto perform_tree_download(TreeTransfer& transfer) const -> bool;
+    auto perform_tree_upload(TreeTransfer& transfer) const -> bool;
+    auto perform_sync(TreeTransfer& transfer, Sync::Session& session) const -> bool;
+    auto perform_sync_upload(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const -> bool;
+    auto perform_sync_download(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const -> bool;
+    auto perform_sync_remove(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const -> bool;
+    auto perform_sync_move(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const -> bool;
+    auto perform_sync_compare(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const -> bool;
+    auto crawl(Sync::Session& session, const Connection& connection, std::string& sync_token, size_t& requests) const -> bool;
+    auto perform_changes(
+      const std::string& remote_directory,
+      std::string& sync_token,
+      std::map<std::string, dict_t>& changed,
+      strings_t& removed,
+      const Connection* connection,
+      size_t& requests
+    ) const -> bool;
+
+    auto perform_create_directory(const Urn::Path& directory_urn, const Connection* connection = nullptr) const -> long;
+    auto perform_check(const std::string& remote_resource) const -> bool;
+    auto perform_info(const std::string& remote_resource) const -> dict_t;
+    auto perform_list(const std::string& remote_directory) const -> strings_t;
+    auto perform_list(const std::string& remote_directory, strings_t& resources) const -> bool;
+
+    auto etag(const std::string& remote_resource) const -> std::string;
+
+    auto prefetch(const strings_t& remote_files) const -> void;
+    auto perform_prefetch(const std::string& remote_file, Prefetcher& prefetcher) const -> void;
+    auto prefetched(const std::string& remote_file, std::string& content) const -> bool;
+
     enum { buffer_size = 1000 * 1000 };
 
     std::string webdav_hostname;
     std::string webdav_root;
-    std::string webdav_username;
-    std::string webdav_password;
-
-    std::string proxy_hostname;
-    std::string proxy_username;
-    std::string proxy_password;
-
-    std::string cert_path;
-    std::string key_path;
+    bool is_etag_recursive;
 
-    dict_t options() const ;
+    std::shared_ptr<Config> config;
+    std::shared_ptr<Cache> cache;
+    std::shared_ptr<Directories> directories;
+    std::shared_ptr<Flights> flights;
+    std::shared_ptr<Prefetcher> prefetcher;
   };
 } // namespace WebDAV
 
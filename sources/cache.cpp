@@ -0,0 +1,270 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "cache.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace WebDAV
+{
+  using std::chrono::steady_clock;
+
+  Cache::Cache(
+    std::chrono::milliseconds ttl_,
+    std::chrono::milliseconds negative_ttl_,
+    size_t capacity
+  ) : ttl(ttl_), negative_ttl(negative_ttl_)
+  {
+    auto shard_capacity = capacity / shards_count;
+    for (auto& shard : shards)
+    {
+      shard.entries.reset(new Lru<std::string, Entry>(shard_capacity));
+    }
+  }
+
+  auto Cache::shard(const std::string& key) -> Shard&
+  {
+    auto hash = std::hash<std::string>()(key);
+    return shards[hash % shards_count];
+  }
+
+  auto Cache::expiration() const -> time_point
+  {
+    return steady_clock::now() + ttl;
+  }
+
+  auto Cache::exists(const std::string& key) -> bool
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) return false;
+    return entry->existence_expiration > steady_clock::now();
+  }
+
+  auto Cache::absent(const std::string& key) -> bool
+  {
+    {
+      auto& shard = this->shard(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto entry = shard.entries->find(key);
+      if (entry != nullptr)
+      {
+        auto now = steady_clock::now();
+        if (entry->absence_expiration > now) return true;
+        if (entry->existence_expiration > now) return false;
+      }
+    }
+
+    if (key == "/") return false;
+
+    // a fresh listing of the parent directory answers without a request
+    auto parent_key = Cache::parent(key);
+    auto& shard = this->shard(parent_key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto parent = shard.entries->find(parent_key);
+    if (parent == nullptr || parent->resources_expiration <= steady_clock::now()) return false;
+
+    auto name = key.substr(parent_key == "/" ? 1 : parent_key.length() + 1);
+    auto directory_name = name + "/";
+    return std::none_of(parent->resources.begin(), parent->resources.end(), [&](const std::string & resource)
+    {
+      return resource == name || resource == directory_name;
+    });
+  }
+
+  auto Cache::information(const std::string& key, dict_t& information) -> bool
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) return false;
+    if (entry->information_expiration <= steady_clock::now()) return false;
+    information = entry->information;
+    return true;
+  }
+
+  auto Cache::resources(const std::string& key, strings_t& resources) -> bool
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) return false;
+    if (entry->resources_expiration <= steady_clock::now()) return false;
+    resources = entry->resources;
+    return true;
+  }
+
+  auto Cache::stale_resources(const std::string& key, strings_t& resources, std::string& etag) -> bool
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) return false;
+    if (entry->resources_expiration == time_point{}) return false;
+    auto it = entry->information.find("etag");
+    if (it == entry->information.end() || it->second.empty()) return false;
+    resources = entry->resources;
+    etag = it->second;
+    return true;
+  }
+
+  auto Cache::put_existence(const std::string& key) -> void
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) entry = &shard.entries->insert(key, Entry{});
+    entry->existence_expiration = this->expiration();
+    entry->absence_expiration = time_point{};
+  }
+
+  auto Cache::put_absence(const std::string& key) -> void
+  {
+    if (negative_ttl.count() == 0) return;
+
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& entry = shard.entries->insert(key, Entry{});
+    entry.absence_expiration = steady_clock::now() + negative_ttl;
+  }
+
+  auto Cache::put_information(const std::string& key, const dict_t& information) -> void
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) entry = &shard.entries->insert(key, Entry{});
+
+    auto etag = information.find("etag");
+    auto cached_etag = entry->information.find("etag");
+    bool is_changed = etag == information.end() || cached_etag == entry->information.end() ||
+                      etag->second != cached_etag->second;
+    if (is_changed)
+    {
+      entry->resources.clear();
+      entry->resources_expiration = time_point{};
+    }
+
+    entry->information = information;
+    entry->existence_expiration = entry->information_expiration = this->expiration();
+    entry->absence_expiration = time_point{};
+  }
+
+  auto Cache::put_resources(const std::string& key, const strings_t& resources) -> void
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) entry = &shard.entries->insert(key, Entry{});
+    entry->resources = resources;
+    entry->existence_expiration = entry->resources_expiration = this->expiration();
+    entry->absence_expiration = time_point{};
+  }
+
+  auto Cache::merge_information(const std::string& key, const dict_t& information) -> void
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) entry = &shard.entries->insert(key, Entry{});
+
+    entry->existence_expiration = this->expiration();
+    entry->absence_expiration = time_point{};
+
+    // a changed resource keeps only what is known to be up to date
+    auto etag = information.find("etag");
+    auto cached_etag = entry->information.find("etag");
+    bool is_fresh = entry->information_expiration > steady_clock::now();
+    bool is_same = etag != information.end() && cached_etag != entry->information.end() &&
+                   !etag->second.empty() && etag->second == cached_etag->second;
+    bool is_complete = etag != information.end() && !etag->second.empty() &&
+                       information.count("modified") != 0 && information.count("size") != 0;
+    bool is_mergeable = is_fresh && (is_same || is_complete);
+    if (!is_mergeable)
+    {
+      entry->information.clear();
+      entry->information_expiration = time_point{};
+      return;
+    }
+
+    for (const auto& field : information)
+    {
+      entry->information[field.first] = field.second;
+    }
+    entry->information_expiration = this->expiration();
+  }
+
+  auto Cache::refresh_resources(const std::string& key) -> void
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.entries->find(key);
+    if (entry == nullptr) return;
+    entry->existence_expiration = entry->resources_expiration = this->expiration();
+  }
+
+  auto Cache::invalidate(const std::string& key) -> void
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries->erase(key);
+  }
+
+  auto Cache::invalidate_tree(const std::string& key) -> void
+  {
+    if (key == "/") return this->clear();
+
+    auto prefix = key + "/";
+    for (auto& shard : shards)
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.entries->erase_if([&key, &prefix](const std::string & item, const Entry&)
+      {
+        return item == key || item.compare(0, prefix.length(), prefix) == 0;
+      });
+    }
+  }
+
+  auto Cache::clear() -> void
+  {
+    for (auto& shard : shards)
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.entries->clear();
+    }
+  }
+
+  auto Cache::key(const std::string& path) -> std::string
+  {
+    if (path.length() > 1 && path.back() == '/') return path.substr(0, path.length() - 1);
+    return path;
+  }
+
+  auto Cache::parent(const std::string& key) -> std::string
+  {
+    auto position = key.rfind('/');
+    if (position == 0 || position == std::string::npos) return "/";
+    return key.substr(0, position);
+  }
+} // namespace WebDAV
@@ -0,0 +1,102 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_CACHE_HPP
+#define WEBDAV_CACHE_HPP
+
+#include "lru.hpp"
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WebDAV
+{
+  using dict_t = std::map<std::string, std::string>;
+  using strings_t = std::vector<std::string>;
+
+  ///
+  /// Thread-safe metadata cache of remote resources.
+  /// Keys are normalized remote paths without a trailing separator,
+  /// see Cache::key. Every kind of metadata has its own time to live,
+  /// missing resources are remembered for a separate (usually shorter) one.
+  ///
+  class Cache
+  {
+  public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    struct Entry
+    {
+      dict_t information;
+      strings_t resources;
+      time_point existence_expiration;
+      time_point information_expiration;
+      time_point resources_expiration;
+      time_point absence_expiration;
+    };
+
+    Cache(std::chrono::milliseconds ttl, std::chrono::milliseconds negative_ttl, size_t capacity);
+
+    auto exists(const std::string& key) -> bool;
+    auto absent(const std::string& key) -> bool;
+    auto information(const std::string& key, dict_t& information) -> bool;
+    auto resources(const std::string& key, strings_t& resources) -> bool;
+    auto stale_resources(const std::string& key, strings_t& resources, std::string& etag) -> bool;
+
+    auto put_existence(const std::string& key) -> void;
+    auto put_absence(const std::string& key) -> void;
+    auto put_information(const std::string& key, const dict_t& information) -> void;
+    auto put_resources(const std::string& key, const strings_t& resources) -> void;
+    auto merge_information(const std::string& key, const dict_t& information) -> void;
+    auto refresh_resources(const std::string& key) -> void;
+
+    auto invalidate(const std::string& key) -> void;
+    auto invalidate_tree(const std::string& key) -> void;
+    auto clear() -> void;
+
+    static auto key(const std::string& path) -> std::string;
+    static auto parent(const std::string& key) -> std::string;
+
+  private:
+    enum { shards_count = 16 };
+
+    struct Shard
+    {
+      std::mutex mutex;
+      std::unique_ptr<Lru<std::string, Entry>> entries;
+    };
+
+    auto shard(const std::string& key) -> Shard&;
+    auto expiration() const -> time_point;
+
+    const std::chrono::milliseconds ttl;
+    const std::chrono::milliseconds negative_ttl;
+    std::array<Shard, shards_count> shards;
+  };
+} // namespace WebDAV
+
+#endif
@@ -21,8 +21,11 @@
 ############################################################################*/
 
 #include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <cstring>
+#include <map>
+#include <string>
 
 #include "callback.hpp"
 
@@ -52,10 +55,31 @@ namespace WebDAV
         auto size = static_cast<unsigned long long>(item_size * item_count);
         auto rest_bytes = data->size - data->position;
         auto copied_bytes = std::min<unsigned long long>(size, rest_bytes);
-        memcpy(ptr, data->buffer, copied_bytes);
+        memcpy(ptr, data->buffer + data->position, copied_bytes);
         data->position += copied_bytes;
         return copied_bytes;
       }
+
+      size_t segments(char* ptr, size_t item_size, size_t item_count, void* segments)
+      {
+        auto data = reinterpret_cast<Segments*>(segments);
+        auto size = item_size * item_count;
+        size_t copied_bytes = 0;
+        while (copied_bytes < size && data->index < data->count)
+        {
+          const auto& segment = data->items[data->index];
+          auto segment_bytes = std::min(size - copied_bytes, segment.second - data->position);
+          memcpy(ptr + copied_bytes, segment.first + data->position, segment_bytes);
+          copied_bytes += segment_bytes;
+          data->position += segment_bytes;
+          if (data->position == segment.second)
+          {
+            ++data->index;
+            data->position = 0;
+          }
+        }
+        return copied_bytes;
+      }
     } // namespace Read
 
     namespace Write
@@ -74,8 +98,9 @@ namespace WebDAV
         auto size = static_cast<unsigned long long>(item_size * item_count);
         auto rest_bytes = data->size - data->position;
         auto copied_bytes = std::min<unsigned long long>(size, rest_bytes);
-        memcpy(data->buffer, ptr, copied_bytes);
+        memcpy(data->buffer + data->position, ptr, copied_bytes);
         data->position += copied_bytes;
+        // a short count makes curl fail the transfer instead of truncating it
         return copied_bytes;
       }
     } // namespace Write
@@ -87,11 +112,17 @@ namespace WebDAV
         auto data = reinterpret_cast<Data*>(buffer);
         auto append_size = item_size * item_count;
         auto new_buffer_size = data->size + append_size;
-        auto new_buffer = new char[new_buffer_size];
-        if (data->size != 0) memcpy(new_buffer, data->buffer, data->size);
-        memcpy(new_buffer + data->size, ptr, append_size);
-        delete[] data->buffer;
-        data->buffer = new_buffer;
+        if (new_buffer_size > data->capacity)
+        {
+          // the buffer grows geometrically to keep appends linear
+          auto new_capacity = std::max<unsigned long long>(new_buffer_size, data->capacity * 2);
+          auto new_buffer = new char[new_capacity];
+          if (data->size != 0) memcpy(new_buffer, data->buffer, data->size);
+          delete[] data->buffer;
+          data->buffer = new_buffer;
+          data->capacity = new_capacity;
+        }
+        memcpy(data->buffer + data->size, ptr, append_size);
         data->size = new_buffer_size;
         return append_size;
       }
@@ -105,5 +136,64 @@ namespace WebDAV
         return write_bytes;
       }
     } // namespace Append
+
+    namespace Compare
+    {
+      size_t stream(char* ptr, size_t item_size, size_t item_count, void* stream)
+      {
+        auto in_stream = reinterpret_cast<std::istream*>(stream);
+        size_t compare_bytes = item_size * item_count;
+        char chunk[4096];
+        for (size_t position = 0; position < compare_bytes;)
+        {
+          auto chunk_size = std::min(sizeof(chunk), compare_bytes - position);
+          in_stream->read(chunk, chunk_size);
+          // a difference fails the stream and stops the transfer
+          if (static_cast<size_t>(in_stream->gcount()) != chunk_size || memcmp(chunk, ptr + position, chunk_size) != 0)
+          {
+            in_stream->setstate(std::ios::failbit);
+            return 0;
+          }
+          position += chunk_size;
+        }
+        return compare_bytes;
+      }
+    } // namespace Compare
+
+    namespace Parse
+    {
+      size_t headers(char* ptr, size_t item_size, size_t item_count, void* headers)
+      {
+        auto dict = reinterpret_cast<std::map<std::string, std::string>*>(headers);
+        size_t line_size = item_size * item_count;
+        std::string line(ptr, line_size);
+
+        // every response (redirects, 100 Continue) starts with its own status line
+        if (line.compare(0, 5, "HTTP/") == 0)
+        {
+          dict->clear();
+          return line_size;
+        }
+
+        auto colon_position = line.find(':');
+        if (colon_position == std::string::npos) return line_size;
+
+        auto name = line.substr(0, colon_position);
+        std::transform(name.begin(), name.end(), name.begin(), [](char symbol)
+        {
+          return static_cast<char>(std::tolower(static_cast<unsigned char>(symbol)));
+        });
+
+        auto value_begin = line.find_first_not_of(" \t", colon_position + 1);
+        auto value_end = line.find_last_not_of(" \t\r\n");
+        std::string value;
+        if (value_begin != std::string::npos && value_end >= value_begin)
+        {
+          value = line.substr(value_begin, value_end - value_begin + 1);
+        }
+        (*dict)[name] = value;
+        return line_size;
+      }
+    } // namespace Parse
   } // namespace Callback
 } // namespace WebDAV
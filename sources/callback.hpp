@@ -23,6 +23,11 @@
 #ifndef WEBDAV_CALLBACK_HPP
 #define WEBDAV_CALLBACK_HPP
 
+#include <curl/curl.h>
+
+#include <cstddef>
+#include <utility>
+
 namespace WebDAV
 {
   struct Data
@@ -30,11 +35,13 @@ namespace WebDAV
     char* buffer;
     unsigned long long position;
     unsigned long long size;
+    unsigned long long capacity;
     void reset()
     {
       buffer = nullptr;
       position = 0;
       size = 0;
+      capacity = 0;
     }
     ~Data()
     {
@@ -42,12 +49,21 @@ namespace WebDAV
     }
   };
 
+  struct Segments
+  {
+    const std::pair<const char*, size_t>* items;
+    size_t count;
+    size_t index;
+    size_t position;
+  };
+
   namespace Callback
   {
     namespace Read
     {
       size_t stream(char* data, size_t size, size_t count, void* stream);
       size_t buffer(char* data, size_t size, size_t count, void* buffer);
+      size_t segments(char* data, size_t size, size_t count, void* segments);
     }
 
     namespace Write
@@ -60,6 +76,46 @@ namespace WebDAV
     {
       size_t stream(char* data, size_t size, size_t count, void* stream);
       size_t buffer(char* data, size_t size, size_t count, void* buffer);
+
+      template <typename Container>
+      struct Target
+      {
+        Container& container;
+        void* handle;
+      };
+
+      ///
+      /// Appends to a std::vector<char> or a std::string,
+      /// which is reserved from Content-Length before the first append
+      ///
+      template <typename Container>
+      size_t container(char* ptr, size_t item_size, size_t item_count, void* target)
+      {
+        auto data = reinterpret_cast<Target<Container>*>(target);
+        auto append_size = item_size * item_count;
+        if (data->container.empty() && data->handle != nullptr)
+        {
+          curl_off_t content_length = -1;
+          curl_easy_getinfo(data->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+          if (content_length > 0) data->container.reserve(static_cast<size_t>(content_length));
+        }
+        data->container.insert(data->container.end(), ptr, ptr + append_size);
+        return append_size;
+      }
+    }
+
+    ///
+    /// Compares the data with the next bytes of a std::istream,
+    /// the stream fails on the first difference
+    ///
+    namespace Compare
+    {
+      size_t stream(char* data, size_t size, size_t count, void* stream);
+    }
+
+    namespace Parse
+    {
+      size_t headers(char* data, size_t size, size_t count, void* headers);
     }
   }
 } // namespace WebDAV
@@ -22,16 +22,35 @@
 
 #include <webdav/client.hpp>
 
+#include "cache.hpp"
 #include "callback.hpp"
+#include "config.hpp"
+#include "directories.hpp"
+#include "fetcher.hpp"
+#include "flight.hpp"
 #include "fsinfo.hpp"
 #include "header.hpp"
+#include "percent.hpp"
+#include "prefetch.hpp"
 #include "pugiext.hpp"
+#include "reader.hpp"
 #include "request.hpp"
+#include "scratch.hpp"
+#include "sender.hpp"
+#include "share.hpp"
+#include "sync.hpp"
+#include "tree.hpp"
 #include "urn.hpp"
 
 #include <boost/lexical_cast.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <sstream>
 #include <thread>
 
 namespace WebDAV
@@ -43,33 +62,197 @@ namespace WebDAV
     else return it->second;
   }
 
+  auto inline get_number(
+    const dict_t& options,
+    const std::string&& name,
+    unsigned long long default_value
+  ) -> unsigned long long
+  {
+    auto value = get(options, std::move(name));
+    if (value.empty()) return default_value;
+    try
+    {
+      return boost::lexical_cast<unsigned long long>(value);
+    }
+    catch (const boost::bad_lexical_cast&)
+    {
+      return default_value;
+    }
+  }
+
   using Urn::Path;
 
-  using progress_funptr = int(*)(void* context, size_t dltotal, size_t dlnow, size_t ultotal, size_t ulnow);
+  auto inline forget(const std::shared_ptr<Cache>& cache, const Path& resource_urn) -> void
+  {
+    if (cache == nullptr) return;
+    auto key = Cache::key(resource_urn.path());
+    cache->invalidate_tree(key);
+    cache->invalidate(Cache::parent(key));
+  }
 
-  dict_t
-  Client::options() const
+  auto inline is_collection(long status) -> bool
+  {
+    // 405 Method Not Allowed is the answer of MKCOL for an existing resource
+    return (status >= 200 && status < 300) || status == 405;
+  }
+
+  auto inline validators_path(const std::string& local_file) -> std::string
+  {
+    return local_file + ".etag";
+  }
+
+  auto inline load_validators(const std::string& local_file) -> dict_t
+  {
+    std::ifstream stream(validators_path(local_file));
+    std::string etag, modified, size;
+    std::getline(stream, etag);
+    std::getline(stream, modified);
+    std::getline(stream, size);
+    if (!stream) return dict_t{};
+    return dict_t
+    {
+      { "etag", etag },
+      { "modified", modified },
+      { "size", size }
+    };
+  }
+
+  auto inline save_validators(const std::string& local_file, const dict_t& validators) -> void
+  {
+    std::ofstream stream(validators_path(local_file), std::ios::trunc);
+    stream << get(validators, "etag") << std::endl
+           << get(validators, "modified") << std::endl
+           << get(validators, "size") << std::endl;
+  }
+
+  auto inline transfer_information(const dict_t& headers) -> dict_t
+  {
+    static const std::pair<const char*, const char*> fields[] =
+    {
+      { "etag", "etag" },
+      { "last-modified", "modified" },
+      { "content-length", "size" },
+      { "content-type", "content_type" }
+    };
+
+    dict_t information;
+    for (const auto& field : fields)
+    {
+      auto it = headers.find(field.first);
+      if (it != headers.end()) information[field.second] = it->second;
+    }
+    return information;
+  }
+
+  auto inline make_url(const std::string& hostname, const Path& resource_urn) -> std::string
+  {
+    // the quoted path is appended in place, without intermediate strings
+    std::string url;
+    url.reserve(hostname.length() + resource_urn.length() + 1);
+    url.append(hostname);
+    resource_urn.quote(url);
+    return url;
+  }
+
+  auto inline decode_href(const pugi::xml_node& response, boost::string_view& path) -> bool
+  {
+    // the document is parsed in place, so the href is decoded right in the response buffer;
+    // a name which is not UTF-8 keeps its bytes as the server sent them, they are encoded
+    // back in the next request, but a NUL byte cannot be in a path, so such an href is refused
+    auto href = response.select_node("*[local-name()='href']").node().first_child();
+    auto value = const_cast<char*>(href.value());
+    return Percent::decode(value, std::strlen(value), path);
+  }
+
+  auto inline downloaded(const std::shared_ptr<Cache>& cache, const Path& file_urn, const dict_t& headers) -> void
   {
+    if (cache == nullptr) return;
+    auto information = transfer_information(headers);
+    information.erase("content_type");
+    cache->merge_information(Cache::key(file_urn.path()), information);
+  }
+
+  auto inline uploaded(
+    const std::shared_ptr<Cache>& cache,
+    const Path& file_urn,
+    bool is_performed,
+    const dict_t& headers,
+    unsigned long long size
+  ) -> void
+  {
+    if (cache == nullptr) return;
+    auto key = Cache::key(file_urn.path());
+    cache->invalidate(Cache::parent(key));
+    if (!is_performed) return cache->invalidate_tree(key);
+
+    // the body of a PUT response is not the resource, take the uploaded size
+    auto information = transfer_information(headers);
+    information.erase("content_type");
+    information["size"] = std::to_string(size);
+    cache->merge_information(key, information);
+  }
+
+  auto inline information(const pugi::xml_node& response) -> dict_t
+  {
+    auto propstat = response.select_node("*[local-name()='propstat']").node();
+    auto prop = propstat.select_node("*[local-name()='prop']").node();
+    auto creation_date = prop.select_node("*[local-name()='creationdate']").node();
+    auto display_name = prop.select_node("*[local-name()='displayname']").node();
+    auto content_length = prop.select_node("*[local-name()='getcontentlength']").node();
+    auto modified_date = prop.select_node("*[local-name()='getlastmodified']").node();
+    auto resource_type = prop.select_node("*[local-name()='resourcetype']").node();
+    auto etag = prop.select_node("*[local-name()='getetag']").node();
+
     return dict_t
     {
-      { "webdav_hostname", this->webdav_hostname },
-      { "webdav_root", this->webdav_root },
-      { "webdav_username", this->webdav_username },
-      { "webdav_password", this->webdav_password },
-      { "proxy_hostname", this->proxy_hostname },
-      { "proxy_username", this->proxy_username },
-      { "proxy_password", this->proxy_password },
-      { "cert_path", this->cert_path },
-      { "key_path", this->key_path },
+      { "created", creation_date.first_child().value() },
+      { "name", display_name.first_child().value() },
+      { "size", content_length.first_child().value() },
+      { "modified", modified_date.first_child().value() },
+      { "type", resource_type.first_child().name() },
+      { "etag", etag.first_child().value() }
     };
   }
 
+  auto inline ctag(const pugi::xml_node& response) -> std::string
+  {
+    auto node = response.select_node(".//*[local-name()='getctag']").node();
+    return node.first_child().value();
+  }
+
+  auto inline escape_xml(const std::string& text) -> std::string
+  {
+    std::string escaped;
+    escaped.reserve(text.length());
+    for (auto symbol : text)
+    {
+      switch (symbol)
+      {
+        case '&': escaped.append("&amp;"); break;
+        case '<': escaped.append("&lt;"); break;
+        case '>': escaped.append("&gt;"); break;
+        default: escaped.push_back(symbol); break;
+      }
+    }
+    return escaped;
+  }
+
+  auto inline is_status(const pugi::xml_node& response, const char* code) -> bool
+  {
+    // the status of a whole response, not of its properties
+    auto status = response.select_node("*[local-name()='status']").node();
+    return std::strstr(status.first_child().value(), code) != nullptr;
+  }
+
+  using progress_funptr = int(*)(void* context, size_t dltotal, size_t dlnow, size_t ultotal, size_t ulnow);
+
   bool
   Client::sync_download(
     const std::string& remote_file,
     const std::string& local_file,
     callback_t callback,
-    progress_t progress
+    progress_t progress,
+    dict_t* information
   ) const
   {
     bool is_existed = this->check(remote_file);
@@ -80,12 +263,24 @@ namespace WebDAV
 
     std::ofstream file_stream(local_file, std::ios::binary);
 
-    Request request(this->options());
+    std::string content;
+    if (this->prefetched(remote_file, content))
+    {
+      file_stream.write(content.data(), content.size());
+      if (callback != nullptr) callback(true);
+      return true;
+    }
+
+    dict_t headers;
 
-    auto url = this->webdav_hostname + file_urn.quote(request.handle);
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "GET");
     request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
     request.set(CURLOPT_HEADER, 0L);
     request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&file_stream));
     request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Write::stream));
@@ -99,11 +294,84 @@ namespace WebDAV
     }
 
     bool is_performed = request.perform();
+    if (is_performed)
+    {
+      downloaded(this->cache, file_urn, headers);
+      if (information != nullptr) *information = transfer_information(headers);
+    }
 
     if (callback != nullptr) callback(is_performed);
     return is_performed;
   }
 
+  bool
+  Client::sync_download_if_modified(
+    const std::string& remote_file,
+    const std::string& local_file,
+    dict_t& validators,
+    progress_t progress
+  ) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + remote_file;
+
+    Header header(Headers::accept(), {});
+
+    if (FileInfo::exists(local_file))
+    {
+      auto etag = get(validators, "etag");
+      auto modified = get(validators, "modified");
+      if (!etag.empty()) header.append("If-None-Match: " + etag);
+      if (!modified.empty()) header.append("If-Modified-Since: " + modified);
+    }
+
+    auto partial_file = FileInfo::temporary(local_file);
+    std::ofstream file_stream(partial_file, std::ios::binary);
+    dict_t headers;
+
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADER, 0L);
+    request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&file_stream));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Write::stream));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    if (progress != nullptr)
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(progress.target<progress_funptr>()));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
+
+    bool is_performed = request.perform();
+    file_stream.close();
+
+    if (!is_performed)
+    {
+      std::remove(partial_file.c_str());
+      return request.status() == 304;
+    }
+
+    if (!FileInfo::replace(partial_file, local_file))
+    {
+      std::remove(partial_file.c_str());
+      return false;
+    }
+
+    downloaded(this->cache, file_urn, headers);
+
+    validators["etag"] = get(headers, "etag");
+    validators["modified"] = get(headers, "last-modified");
+    return true;
+  }
+
   bool
   Client::sync_download_to(
     const std::string& remote_file,
@@ -116,17 +384,31 @@ namespace WebDAV
     bool is_existed = this->check(remote_file);
     if (!is_existed) return false;
 
+    std::string content;
+    if (this->prefetched(remote_file, content))
+    {
+      buffer_ptr = new char[content.size()];
+      memcpy(buffer_ptr, content.data(), content.size());
+      buffer_size = content.size();
+      if (callback != nullptr) callback(true);
+      return true;
+    }
+
     auto root_urn = Path(this->webdav_root, true);
     auto file_urn = root_urn + remote_file;
 
-    Data data = { nullptr, 0, 0 };
+    Data data = { nullptr, 0, 0, 0 };
+
+    dict_t headers;
 
-    Request request(this->options());
+    Request request(*this->config);
 
-    auto url = this->webdav_hostname + file_urn.quote(request.handle);
+    auto url = make_url(this->webdav_hostname, file_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "GET");
     request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
     request.set(CURLOPT_HEADER, 0L);
     request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
     request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
@@ -143,12 +425,68 @@ namespace WebDAV
     if (callback != nullptr) callback(is_performed);
     if (!is_performed) return false;
 
+    downloaded(this->cache, file_urn, headers);
+
     buffer_ptr = data.buffer;
     buffer_size = data.size;
     data.reset();
     return true;
   }
 
+  template <typename Container>
+  bool
+  Client::sync_download_to(
+    const std::string& remote_file,
+    Container& container,
+    progress_t progress
+  ) const
+  {
+    bool is_existed = this->check(remote_file);
+    if (!is_existed) return false;
+
+    container.clear();
+
+    std::string content;
+    if (this->prefetched(remote_file, content))
+    {
+      container.assign(content.begin(), content.end());
+      return true;
+    }
+
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + remote_file;
+
+    dict_t headers;
+
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    Callback::Append::Target<Container> target = { container, request.handle };
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_HEADER, 0L);
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&target));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::container<Container>));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    if (progress != nullptr)
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(progress.target<progress_funptr>()));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
+
+    bool is_performed = request.perform();
+    if (!is_performed) return false;
+
+    downloaded(this->cache, file_urn, headers);
+    return true;
+  }
+
   bool
   Client::sync_download_to(
     const std::string& remote_file,
@@ -160,15 +498,27 @@ namespace WebDAV
     bool is_existed = this->check(remote_file);
     if (!is_existed) return false;
 
+    std::string content;
+    if (this->prefetched(remote_file, content))
+    {
+      stream.write(content.data(), content.size());
+      if (callback != nullptr) callback(true);
+      return true;
+    }
+
     auto root_urn = Path(this->webdav_root, true);
     auto file_urn = root_urn + remote_file;
 
-    Request request(this->options());
+    dict_t headers;
 
-    auto url = this->webdav_hostname + file_urn.quote(request.handle);
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "GET");
     request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
     request.set(CURLOPT_HEADER, 0L);
     request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&stream));
     request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Write::stream));
@@ -182,6 +532,7 @@ namespace WebDAV
     }
 
     bool is_performed = request.perform();
+    if (is_performed) downloaded(this->cache, file_urn, headers);
     if (callback != nullptr) callback(is_performed);
 
     return is_performed;
@@ -192,7 +543,8 @@ namespace WebDAV
     const std::string& remote_file,
     const std::string& local_file,
     callback_t callback,
-    progress_t progress
+    progress_t progress,
+    dict_t* information
   ) const
   {
     bool is_existed = FileInfo::exists(local_file);
@@ -204,14 +556,19 @@ namespace WebDAV
     std::ifstream file_stream(local_file, std::ios::binary);
     auto size = FileInfo::size(local_file);
 
-    Request request(this->options());
+    dict_t headers;
 
-    auto url = this->webdav_hostname + file_urn.quote(request.handle);
+    Request request(*this->config);
 
-    Data response = { nullptr, 0, 0 };
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    Scratch scratch;
+    auto& response = scratch.data();
 
     request.set(CURLOPT_UPLOAD, 1L);
     request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
     request.set(CURLOPT_READDATA, reinterpret_cast<size_t>(&file_stream));
     request.set(CURLOPT_READFUNCTION, reinterpret_cast<size_t>(Callback::Read::stream));
     request.set(CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(size));
@@ -228,6 +585,13 @@ namespace WebDAV
     }
 
     bool is_performed = request.perform();
+    uploaded(this->cache, file_urn, is_performed, headers, size);
+    if (is_performed && information != nullptr)
+    {
+      *information = transfer_information(headers);
+      (*information)["size"] = std::to_string(size);
+      information->erase("content_type");
+    }
 
     if (callback != nullptr) callback(is_performed);
     return is_performed;
@@ -245,16 +609,21 @@ namespace WebDAV
     auto root_urn = Path(this->webdav_root, true);
     auto file_urn = root_urn + remote_file;
 
-    Data data = { buffer_ptr, 0, buffer_size };
+    Data data = { buffer_ptr, 0, buffer_size, buffer_size };
+
+    dict_t headers;
 
-    Request request(this->options());
+    Request request(*this->config);
 
-    auto url = this->webdav_hostname + file_urn.quote(request.handle);
+    auto url = make_url(this->webdav_hostname, file_urn);
 
-    Data response = { nullptr, 0, 0 };
+    Scratch scratch;
+    auto& response = scratch.data();
 
     request.set(CURLOPT_UPLOAD, 1L);
     request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
     request.set(CURLOPT_READDATA, reinterpret_cast<size_t>(&data));
     request.set(CURLOPT_READFUNCTION, reinterpret_cast<size_t>(Callback::Read::buffer));
     request.set(CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(buffer_size));
@@ -271,6 +640,7 @@ namespace WebDAV
     }
 
     bool is_performed = request.perform();
+    uploaded(this->cache, file_urn, is_performed, headers, buffer_size);
 
     if (callback != nullptr) callback(is_performed);
 
@@ -289,17 +659,22 @@ namespace WebDAV
     auto root_urn = Path(this->webdav_root, true);
     auto file_urn = root_urn + remote_file;
 
-    Request request(this->options());
+    dict_t headers;
 
-    auto url = this->webdav_hostname + file_urn.quote(request.handle);
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
     stream.seekg(0, std::ios::end);
     size_t stream_size = stream.tellg();
     stream.seekg(0, std::ios::beg);
 
-    Data response = { nullptr, 0, 0 };
+    Scratch scratch;
+    auto& response = scratch.data();
 
     request.set(CURLOPT_UPLOAD, 1L);
     request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
     request.set(CURLOPT_READDATA, reinterpret_cast<size_t>(&stream));
     request.set(CURLOPT_READFUNCTION, reinterpret_cast<size_t>(Callback::Read::stream));
     request.set(CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(stream_size));
@@ -316,6 +691,59 @@ namespace WebDAV
     }
 
     bool is_performed = request.perform();
+    uploaded(this->cache, file_urn, is_performed, headers, stream_size);
+
+    if (callback != nullptr) callback(is_performed);
+    return is_performed;
+  }
+
+  bool
+  Client::sync_upload_from(
+    const std::string& remote_file,
+    const segments_t& segments,
+    callback_t callback,
+    progress_t progress
+  ) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + remote_file;
+
+    unsigned long long size = 0;
+    for (const auto& segment : segments) size += segment.second;
+
+    // the segments are copied straight into the buffer of the request
+    Segments data = { segments.data(), segments.size(), 0, 0 };
+
+    dict_t headers;
+
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    Scratch scratch;
+    auto& response = scratch.data();
+
+    request.set(CURLOPT_UPLOAD, 1L);
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_READDATA, reinterpret_cast<size_t>(&data));
+    request.set(CURLOPT_READFUNCTION, reinterpret_cast<size_t>(Callback::Read::segments));
+    request.set(CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(size));
+    request.set(CURLOPT_BUFFERSIZE, static_cast<long>(Client::buffer_size));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&response));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    if (progress != nullptr)
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(progress.target<progress_funptr>()));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
+
+    bool is_performed = request.perform();
+    uploaded(this->cache, file_urn, is_performed, headers, size);
 
     if (callback != nullptr) callback(is_performed);
     return is_performed;
@@ -325,46 +753,56 @@ namespace WebDAV
   {
     this->webdav_hostname = get(options, "webdav_hostname");
     this->webdav_root = get(options, "webdav_root");
-    this->webdav_username = get(options, "webdav_username");
-    this->webdav_password = get(options, "webdav_password");
 
-    this->proxy_hostname = get(options, "proxy_hostname");
-    this->proxy_username = get(options, "proxy_username");
-    this->proxy_password = get(options, "proxy_password");
+    this->is_etag_recursive = get_number(options, "recursive_etags", 0) != 0;
+
+    this->config = std::make_shared<Config>(options);
+
+    this->flights = std::make_shared<Flights>();
+
+    auto cache_ttl = get_number(options, "cache_ttl", 0);
+    auto negative_cache_ttl = get_number(options, "negative_cache_ttl", 0);
+    auto cache_capacity = get_number(options, "cache_capacity", 10000);
+    auto directory_cache_ttl = get_number(options, "directory_cache_ttl", 0);
+    this->directories = std::make_shared<Directories>(std::chrono::milliseconds(directory_cache_ttl), cache_capacity);
+    if (cache_ttl != 0 || negative_cache_ttl != 0)
+    {
+      this->cache = std::make_shared<Cache>(
+        std::chrono::milliseconds(cache_ttl),
+        std::chrono::milliseconds(negative_cache_ttl),
+        cache_capacity
+      );
+    }
 
-    this->cert_path = get(options, "cert_path");
-    this->key_path = get(options, "key_path");
+    auto prefetch_count = get_number(options, "prefetch_count", 0);
+    auto prefetch_size_limit = get_number(options, "prefetch_size_limit", 64 * 1024);
+    auto prefetch_capacity = get_number(options, "prefetch_capacity", 16 * 1024 * 1024);
+    if (this->cache != nullptr && prefetch_count != 0)
+    {
+      this->prefetcher = std::make_shared<Prefetcher>(prefetch_count, prefetch_size_limit, prefetch_capacity);
+    }
   }
 
   unsigned long long
   Client::free_size() const
   {
-    Header header =
-    {
-      "Accept: */*",
-      "Depth: 0",
-      "Content-Type: text/xml"
-    };
-
-    pugi::xml_document document;
-    auto propfind = document.append_child("D:propfind");
-    propfind.append_attribute("xmlns:D") = "DAV:";
-
-    auto prop = propfind.append_child("D:prop");
-    prop.append_child("D:quokta-available-bytes");
-    prop.append_child("D:quota-used-bytes");
+    const auto& header = Headers::properties();
 
-    auto document_print = pugi::node_to_string(document);
-    size_t size = document_print.length() * sizeof((document_print.c_str())[0]);
+    static const char body[] =
+      "<?xml version=\"1.0\"?>"
+      "<D:propfind xmlns:D=\"DAV:\"><D:prop>"
+      "<D:quota-available-bytes/><D:quota-used-bytes/>"
+      "</D:prop></D:propfind>";
 
-    Data data = { nullptr, 0, 0 };
+    Scratch scratch;
+    auto& data = scratch.data();
 
-    Request request(this->options());
+    Request request(*this->config);
 
     request.set(CURLOPT_CUSTOMREQUEST, "PROPFIND");
     request.set(CURLOPT_HTTPHEADER, reinterpret_cast<struct curl_slist*>(header.handle));
-    request.set(CURLOPT_POSTFIELDS, document_print.c_str());
-    request.set(CURLOPT_POSTFIELDSIZE, static_cast<long>(size));
+    request.set(CURLOPT_POSTFIELDS, body);
+    request.set(CURLOPT_POSTFIELDSIZE, static_cast<long>(sizeof(body) - 1));
     request.set(CURLOPT_HEADER, 0);
     request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
     request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
@@ -375,12 +813,13 @@ namespace WebDAV
     auto is_performed = request.perform();
     if (!is_performed) return 0;
 
-    document.load_buffer(data.buffer, static_cast<size_t>(data.size));
+    pugi::xml_document document;
+    document.load_buffer_inplace(data.buffer, static_cast<size_t>(data.size));
 
     pugi::xml_node multistatus = document.select_node("*[local-name()='multistatus']").node();
     pugi::xml_node response = multistatus.select_node("*[local-name()='response']").node();
     pugi::xml_node propstat = response.select_node("*[local-name()='propstat']").node();
-    prop = propstat.select_node("*[local-name()='prop']").node();
+    pugi::xml_node prop = propstat.select_node("*[local-name()='prop']").node();
     pugi::xml_node quota_available_bytes = prop.select_node("*[local-name()='quota-available-bytes']").node();
     std::string free_size_text = quota_available_bytes.first_child().value();
 
@@ -393,17 +832,34 @@ namespace WebDAV
     auto root_urn = Path(this->webdav_root, true);
     auto resource_urn = root_urn + remote_resource;
 
-    Header header =
+    auto key = Cache::key(resource_urn.path());
+    if (this->cache != nullptr)
     {
-      "Accept: */*",
-      "Depth: 1"
-    };
+      if (this->cache->exists(key)) return true;
+      if (this->cache->absent(key)) return false;
+    }
+
+    return this->flights->existence.share(key, [this, &remote_resource]()
+    {
+      return this->perform_check(remote_resource);
+    });
+  }
 
-    Data data = { nullptr, 0, 0 };
+  bool
+  Client::perform_check(const std::string& remote_resource) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto resource_urn = root_urn + remote_resource;
+    auto key = Cache::key(resource_urn.path());
 
-    Request request(this->options());
+    const auto& header = Headers::listing();
 
-    auto url = this->webdav_hostname + resource_urn.quote(request.handle);
+    Scratch scratch;
+    auto& data = scratch.data();
+
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, resource_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "PROPFIND");
     request.set(CURLOPT_URL, url.c_str());
@@ -414,85 +870,130 @@ namespace WebDAV
     request.set(CURLOPT_VERBOSE, 1);
 #endif
 
-    return request.perform();
+    bool is_existed = request.perform();
+    if (this->cache != nullptr)
+    {
+      if (is_existed) this->cache->put_existence(key);
+      else if (request.status() == 404) this->cache->put_absence(key);
+    }
+    return is_existed;
   }
 
-  dict_t
-  Client::info(const std::string& remote_resource) const
+  std::string
+  Client::etag(const std::string& remote_resource) const
   {
     auto root_urn = Path(this->webdav_root, true);
-    auto target_urn = root_urn + remote_resource;
+    auto resource_urn = root_urn + remote_resource;
 
-    Header header =
-    {
-      "Accept: */*",
-      "Depth: 1"
-    };
+    const auto& header = Headers::properties();
+
+    static const char body[] =
+      "<?xml version=\"1.0\"?>"
+      "<D:propfind xmlns:D=\"DAV:\"><D:prop><D:getetag/></D:prop></D:propfind>";
 
-    Data data = { nullptr, 0, 0 };
+    Scratch scratch;
+    auto& data = scratch.data();
 
-    Request request(this->options());
+    Request request(*this->config);
 
-    auto url = this->webdav_hostname + target_urn.quote(request.handle);
+    auto url = make_url(this->webdav_hostname, resource_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "PROPFIND");
     request.set(CURLOPT_URL, url.c_str());
     request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+    request.set(CURLOPT_POSTFIELDS, body);
+    request.set(CURLOPT_POSTFIELDSIZE, static_cast<long>(sizeof(body) - 1));
     request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
     request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
 #ifdef WDC_VERBOSE
     request.set(CURLOPT_VERBOSE, 1);
 #endif
-    bool is_performed = request.perform();
 
-    if (!is_performed) return dict_t{};
+    bool is_performed = request.perform();
+    if (!is_performed) return std::string{};
 
     pugi::xml_document document;
-    document.load_buffer(data.buffer, static_cast<size_t>(data.size));
-#ifdef WDC_VERBOSE
-    document.save(std::cout);
-#endif
-    auto multistatus = document.select_node("*[local-name()='multistatus']").node();
-    auto responses = multistatus.select_nodes("*[local-name()='response']");
-    for (auto response : responses)
-    {
-      pugi::xml_node href = response.node().select_node("*[local-name()='href']").node();
-      std::string encode_file_name = href.first_child().value();
-      std::string resource_path = curl_unescape(encode_file_name.c_str(), static_cast<int>(encode_file_name.length()));
-      auto target_path = target_urn.path();
-      auto target_path_without_sep = target_path;
-      if (!target_path_without_sep.empty() && target_path_without_sep.back() == '/')
-        target_path_without_sep.resize(target_path_without_sep.length() - 1);
-      auto resource_path_without_sep = resource_path;
-      if (!resource_path_without_sep.empty() && resource_path_without_sep.back() == '/')
-        resource_path_without_sep.resize(resource_path_without_sep.length() - 1);
-      if (resource_path_without_sep == target_path_without_sep)
-      {
-        auto propstat = response.node().select_node("*[local-name()='propstat']").node();
-        auto prop = propstat.select_node("*[local-name()='prop']").node();
-        auto creation_date = prop.select_node("*[local-name()='creationdate']").node();
-        auto display_name = prop.select_node("*[local-name()='displayname']").node();
-        auto content_length = prop.select_node("*[local-name()='getcontentlength']").node();
-        auto modified_date = prop.select_node("*[local-name()='getlastmodified']").node();
-        auto resource_type = prop.select_node("*[local-name()='resourcetype']").node();
-
-        dict_t information =
-        {
-          { "created", creation_date.first_child().value() },
-          { "name", display_name.first_child().value() },
-          { "size", content_length.first_child().value() },
-          { "modified", modified_date.first_child().value() },
-          { "type", resource_type.first_child().name() }
-        };
-
-        return information;
-      }
-    }
-
-    return dict_t{};
+    document.load_buffer_inplace(data.buffer, static_cast<size_t>(data.size));
+    auto etag = document.select_node("//*[local-name()='getetag']").node();
+    return etag.first_child().value();
   }
 
-  bool
+  dict_t
+  Client::info(const std::string& remote_resource) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto target_urn = root_urn + remote_resource;
+
+    auto key = Cache::key(target_urn.path());
+    dict_t cached_information;
+    if (this->cache != nullptr)
+    {
+      if (this->cache->information(key, cached_information)) return cached_information;
+      if (this->cache->absent(key)) return dict_t{};
+    }
+
+    return this->flights->information.share(key, [this, &remote_resource]()
+    {
+      return this->perform_info(remote_resource);
+    });
+  }
+
+  dict_t
+  Client::perform_info(const std::string& remote_resource) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto target_urn = root_urn + remote_resource;
+    auto key = Cache::key(target_urn.path());
+
+    const auto& header = Headers::listing();
+
+    Scratch scratch;
+    auto& data = scratch.data();
+
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, target_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "PROPFIND");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    bool is_performed = request.perform();
+
+    if (!is_performed)
+    {
+      if (this->cache != nullptr && request.status() == 404) this->cache->put_absence(key);
+      return dict_t{};
+    }
+
+    pugi::xml_document document;
+    document.load_buffer_inplace(data.buffer, static_cast<size_t>(data.size));
+#ifdef WDC_VERBOSE
+    document.save(std::cout);
+#endif
+    auto multistatus = document.select_node("*[local-name()='multistatus']").node();
+    auto responses = multistatus.select_nodes("*[local-name()='response']");
+    for (auto response : responses)
+    {
+      boost::string_view resource_path;
+      if (!decode_href(response.node(), resource_path)) continue;
+      if (!resource_path.empty() && resource_path.back() == '/') resource_path.remove_suffix(1);
+      if (resource_path == target_urn.key())
+      {
+        auto resource_information = information(response.node());
+        if (this->cache != nullptr) this->cache->put_information(key, resource_information);
+        return resource_information;
+      }
+    }
+
+    return dict_t{};
+  }
+
+  bool
   Client::is_directory(const std::string& remote_resource) const
   {
     auto information = this->info(remote_resource);
@@ -503,133 +1004,1194 @@ namespace WebDAV
 
   strings_t
   Client::list(const std::string& remote_directory) const
+  {
+    auto target_urn = Path(this->webdav_root, true) + remote_directory;
+    target_urn = Path(target_urn.path(), true);
+
+    auto key = Cache::key(target_urn.path());
+    if (this->cache != nullptr)
+    {
+      strings_t cached_resources;
+      if (this->cache->resources(key, cached_resources)) return cached_resources;
+
+      std::string cached_etag;
+      bool is_revalidated = this->cache->stale_resources(key, cached_resources, cached_etag) &&
+                            this->etag(remote_directory) == cached_etag;
+      if (is_revalidated)
+      {
+        this->cache->refresh_resources(key);
+        return cached_resources;
+      }
+    }
+
+    return this->flights->resources.share(key, [this, &remote_directory]()
+    {
+      return this->perform_list(remote_directory);
+    });
+  }
+
+  strings_t
+  Client::perform_list(const std::string& remote_directory) const
   {
     bool is_existed = this->check(remote_directory);
     if (!is_existed) return strings_t{};
 
+    strings_t resources;
+    this->perform_list(remote_directory, resources);
+    return resources;
+  }
+
+  bool
+  Client::perform_list(const std::string& remote_directory, strings_t& resources) const
+  {
+    resources.clear();
+
     auto target_urn = Path(this->webdav_root, true) + remote_directory;
     target_urn = Path(target_urn.path(), true);
+    auto key = Cache::key(target_urn.path());
 
-    Header header =
+    const auto& header = Headers::listing();
+
+    Scratch scratch;
+    auto& data = scratch.data();
+
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, target_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "PROPFIND");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+    request.set(CURLOPT_HEADER, 0);
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+    bool is_performed = request.perform();
+
+    if (!is_performed) return false;
+
+    strings_t prefetched_files;
+
+    pugi::xml_document document;
+    if (!document.load_buffer_inplace(data.buffer, static_cast<size_t>(data.size))) return false;
+    auto multistatus = document.select_node("*[local-name()='multistatus']").node();
+    if (!multistatus) return false;
+    auto responses = multistatus.select_nodes("*[local-name()='response']");
+    for (auto response : responses)
     {
-      "Accept: */*",
-      "Depth: 1"
-    };
+      boost::string_view resource_path;
+      if (!decode_href(response.node(), resource_path)) continue;
+      Path resource_urn(resource_path);
+      if (resource_urn == target_urn)
+      {
+        if (this->cache != nullptr) this->cache->put_information(key, information(response.node()));
+        continue;
+      }
+      resources.push_back(resource_urn.name());
+      if (this->cache != nullptr)
+      {
+        auto resource_information = information(response.node());
+        this->cache->put_information(Cache::key(resource_urn.path()), resource_information);
+
+        bool is_prefetched = this->prefetcher != nullptr &&
+                             prefetched_files.size() < this->prefetcher->count &&
+                             !resource_urn.is_directory() &&
+                             resource_information["type"].find("collection") == std::string::npos &&
+                             !resource_information["etag"].empty() &&
+                             get_number(resource_information, "size", ~0ull) <= this->prefetcher->size_limit;
+        if (is_prefetched) prefetched_files.push_back(remote_directory + "/" + resource_urn.name());
+      }
+    }
+
+    if (this->cache != nullptr) this->cache->put_resources(key, resources);
+    this->prefetch(prefetched_files);
+    return true;
+  }
+
+  bool
+  Client::changes(
+    const std::string& remote_directory,
+    std::string& sync_token,
+    std::map<std::string, dict_t>& changed,
+    strings_t& removed
+  ) const
+  {
+    size_t requests = 0;
+    return this->perform_changes(remote_directory, sync_token, changed, removed, nullptr, requests);
+  }
+
+  bool
+  Client::perform_changes(
+    const std::string& remote_directory,
+    std::string& sync_token,
+    std::map<std::string, dict_t>& changed,
+    strings_t& removed,
+    const Connection* connection,
+    size_t& requests
+  ) const
+  {
+    changed.clear();
+    removed.clear();
+
+    auto target_urn = Path((Path(this->webdav_root, true) + remote_directory).path(), true);
+    auto target_key = target_urn.key();
+    auto prefix_length = target_urn.is_root() ? target_key.length() : target_key.length() + 1;
+
+    const auto& header = Headers::properties();
+    auto url = make_url(this->webdav_hostname, target_urn);
+
+    // a truncated report (507 for the directory itself) is continued with its token
+    for (bool is_truncated = true; is_truncated;)
+    {
+      is_truncated = false;
+
+      auto body =
+        "<?xml version=\"1.0\"?>"
+        "<D:sync-collection xmlns:D=\"DAV:\">"
+        "<D:sync-token>" + escape_xml(sync_token) + "</D:sync-token>"
+        "<D:sync-level>infinite</D:sync-level>"
+        "<D:prop><D:resourcetype/><D:getcontentlength/><D:getlastmodified/><D:getetag/></D:prop>"
+        "</D:sync-collection>";
+
+      Scratch scratch;
+      auto& data = scratch.data();
+
+      auto request = connection == nullptr ? Request(*this->config) : Request(*this->config, *connection);
+
+      request.set(CURLOPT_CUSTOMREQUEST, "REPORT");
+      request.set(CURLOPT_URL, url.c_str());
+      request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+      request.set(CURLOPT_POSTFIELDS, body.c_str());
+      request.set(CURLOPT_POSTFIELDSIZE, static_cast<long>(body.length()));
+      request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
+      request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
+#ifdef WDC_VERBOSE
+      request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+      ++requests;
+      if (!request.perform())
+      {
+        sync_token.clear();
+        return false;
+      }
+
+      pugi::xml_document document;
+      document.load_buffer_inplace(data.buffer, static_cast<size_t>(data.size));
+      auto multistatus = document.select_node("*[local-name()='multistatus']").node();
+      auto token = multistatus.select_node("*[local-name()='sync-token']").node().first_child().value();
+      if (*token == '\0')
+      {
+        sync_token.clear();
+        return false;
+      }
+      sync_token = token;
+
+      auto responses = multistatus.select_nodes("*[local-name()='response']");
+      for (auto response : responses)
+      {
+        boost::string_view resource_path;
+        if (!decode_href(response.node(), resource_path)) continue;
+        Path resource_urn(resource_path);
+        if (resource_urn == target_urn)
+        {
+          is_truncated = is_status(response.node(), " 507");
+          continue;
+        }
+
+        auto resource_key = resource_urn.key();
+        bool is_below = resource_key.length() > prefix_length &&
+                        resource_key.starts_with(target_key) &&
+                        (target_urn.is_root() || resource_key[target_key.length()] == '/');
+        if (!is_below) continue;
+        auto path = resource_urn.path().substr(prefix_length);
+
+        auto key = Cache::key(resource_urn.path());
+        forget(this->cache, resource_urn);
+        if (is_status(response.node(), " 404"))
+        {
+          this->directories->erase_tree(key);
+          removed.push_back(std::move(path));
+          continue;
+        }
+
+        auto resource_information = information(response.node());
+        bool is_directory = resource_information["type"].find("collection") != std::string::npos;
+        if (is_directory && path.back() != '/') path.push_back('/');
+        if (this->cache != nullptr) this->cache->put_information(key, resource_information);
+        changed[path] = std::move(resource_information);
+      }
+    }
+    return true;
+  }
+
+  bool Client::download(
+    const std::string& remote_file,
+    const std::string& local_file,
+    progress_t progress
+  ) const
+  {
+    return this->sync_download(remote_file, local_file, nullptr, std::move(progress));
+  }
+
+  bool
+  Client::download(
+    const std::string& remote_file,
+    const std::string& local_file,
+    dict_t& information,
+    progress_t progress
+  ) const
+  {
+    return this->sync_download(remote_file, local_file, nullptr, std::move(progress), &information);
+  }
+
+  bool
+  Client::download_if_modified(
+    const std::string& remote_file,
+    const std::string& local_file,
+    progress_t progress
+  ) const
+  {
+    auto validators = load_validators(local_file);
+    auto size = get(validators, "size");
+    bool is_untouched = FileInfo::exists(local_file) && size == std::to_string(FileInfo::size(local_file));
+    if (!is_untouched) validators.clear();
+
+    bool is_downloaded = this->sync_download_if_modified(remote_file, local_file, validators, std::move(progress));
+    if (!is_downloaded) return false;
+
+    validators["size"] = std::to_string(FileInfo::size(local_file));
+    save_validators(local_file, validators);
+    return true;
+  }
+
+  bool
+  Client::download_if_modified(
+    const std::string& remote_file,
+    const std::string& local_file,
+    dict_t& validators,
+    progress_t progress
+  ) const
+  {
+    return this->sync_download_if_modified(remote_file, local_file, validators, std::move(progress));
+  }
+
+  void
+  Client::async_download(
+    const std::string& remote_file,
+    const std::string& local_file,
+    callback_t callback,
+    progress_t progress
+  ) const
+  {
+    std::thread downloading([ = ]()
+    {
+      this->sync_download(remote_file, local_file, callback, std::move(progress));
+    });
+    downloading.detach();
+  }
+
+  bool
+  Client::download_tree(
+    const std::string& remote_directory,
+    const std::string& local_directory,
+    size_t parallelism,
+    tree_progress_t progress
+  ) const
+  {
+    if (!this->check(remote_directory)) return false;
+    if (!FileInfo::create_directory(local_directory)) return false;
+
+    // the tree is crawled first, so the number of files is known
+    // before the downloads start; a directory which cannot be listed
+    // fails the tree rather than leaving out its subtree
+    Tree::items_t files;
+    std::deque<TreeItem> directories{ TreeItem{ remote_directory, local_directory } };
+    strings_t resources;
+    while (!directories.empty())
+    {
+      auto directory = std::move(directories.front());
+      directories.pop_front();
+
+      if (!this->perform_list(directory.remote, resources)) return false;
+      for (const auto& name : resources)
+      {
+        bool is_directory = !name.empty() && name.back() == '/';
+        auto resource_name = is_directory ? name.substr(0, name.length() - 1) : name;
+        if (resource_name.empty() || resource_name == "." || resource_name == "..") continue;
+
+        TreeItem item{ directory.remote + "/" + resource_name, directory.local + "/" + resource_name };
+        if (!is_directory)
+        {
+          files.push_back(std::move(item));
+          continue;
+        }
+        if (!FileInfo::create_directory(item.local)) return false;
+        directories.push_back(std::move(item));
+      }
+    }
+
+    Tree tree(std::move(files), std::move(progress));
+    return tree.run(parallelism, [this](TreeTransfer & transfer)
+    {
+      return this->perform_tree_download(transfer);
+    });
+  }
+
+  bool
+  Client::perform_tree_download(TreeTransfer& transfer) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + transfer.item->remote;
+
+    // the temporary name does not clash with a sibling downloaded meanwhile
+    const auto& local_file = transfer.item->local;
+    auto partial_file = FileInfo::temporary(local_file);
+    std::ofstream file_stream(partial_file, std::ios::binary);
+    if (!file_stream.is_open()) return false;
+
+    dict_t headers;
+
+    Request request(*this->config, *transfer.connection);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADER, 0L);
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&file_stream));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Write::stream));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    if (transfer.tree->is_reported())
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(Tree::progress));
+      request.set(CURLOPT_XFERINFODATA, reinterpret_cast<size_t>(&transfer));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
+
+    bool is_performed = request.perform();
+    file_stream.close();
+
+    if (!is_performed || file_stream.fail())
+    {
+      std::remove(partial_file.c_str());
+      return false;
+    }
+
+    if (!FileInfo::replace(partial_file, local_file))
+    {
+      std::remove(partial_file.c_str());
+      return false;
+    }
+
+    downloaded(this->cache, file_urn, headers);
+    return true;
+  }
+
+  bool
+  Client::download_to(
+    const std::string& remote_file,
+    char*& buffer_ptr,
+    unsigned long long& buffer_size,
+    progress_t progress
+  ) const
+  {
+    return this->sync_download_to(remote_file, buffer_ptr, buffer_size, nullptr, std::move(progress));
+  }
+
+  bool
+  Client::download_to(
+    const std::string& remote_file,
+    std::ostream& stream,
+    progress_t progress
+  ) const
+  {
+    return this->sync_download_to(remote_file, stream, nullptr, std::move(progress));
+  }
+
+  bool
+  Client::download_to(
+    const std::string& remote_file,
+    std::vector<char>& buffer,
+    progress_t progress
+  ) const
+  {
+    return this->sync_download_to(remote_file, buffer, std::move(progress));
+  }
+
+  bool
+  Client::download_to(
+    const std::string& remote_file,
+    std::string& buffer,
+    progress_t progress
+  ) const
+  {
+    return this->sync_download_to(remote_file, buffer, std::move(progress));
+  }
+
+  bool
+  Client::download_into(
+    const std::string& remote_file,
+    char* buffer_ptr,
+    unsigned long long buffer_capacity,
+    unsigned long long& buffer_size,
+    progress_t progress
+  ) const
+  {
+    bool is_existed = this->check(remote_file);
+    if (!is_existed) return false;
+
+    std::string content;
+    if (this->prefetched(remote_file, content))
+    {
+      if (content.size() > buffer_capacity) return false;
+      memcpy(buffer_ptr, content.data(), content.size());
+      buffer_size = content.size();
+      return true;
+    }
+
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + remote_file;
+
+    Data data = { buffer_ptr, 0, buffer_capacity, buffer_capacity };
+
+    dict_t headers;
+
+    Request request(*this->config);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_HEADER, 0L);
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Write::buffer));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    if (progress != nullptr)
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(progress.target<progress_funptr>()));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
+
+    bool is_performed = request.perform();
+    buffer_size = data.position;
+    data.reset();
+    if (!is_performed) return false;
+
+    downloaded(this->cache, file_urn, headers);
+    return true;
+  }
+
+  bool
+  Client::upload_tree(
+    const std::string& remote_directory,
+    const std::string& local_directory,
+    size_t parallelism,
+    tree_progress_t progress
+  ) const
+  {
+    // the local tree is walked first: every directory precedes its items,
+    // so it is created exactly once and before anything is put into it;
+    // a walked directory carries its own index as the parent of its items
+    Tree::items_t items;
+    std::deque<TreeItem> directories{ TreeItem{ remote_directory, local_directory } };
+    while (!directories.empty())
+    {
+      auto directory = std::move(directories.front());
+      directories.pop_front();
+
+      strings_t files;
+      strings_t subdirectories;
+      if (!FileInfo::list(directory.local, files, subdirectories)) return false;
+
+      for (const auto& name : files)
+      {
+        items.emplace_back(directory.remote + "/" + name, directory.local + "/" + name, false, directory.parent);
+      }
+      for (const auto& name : subdirectories)
+      {
+        items.emplace_back(directory.remote + "/" + name, directory.local + "/" + name, true, directory.parent);
+        directories.emplace_back(items.back().remote, items.back().local, true, items.size() - 1);
+      }
+    }
+
+    if (!this->create_directory(remote_directory, true)) return false;
+
+    Tree tree(std::move(items), std::move(progress));
+    return tree.run(parallelism, [this](TreeTransfer & transfer)
+    {
+      return this->perform_tree_upload(transfer);
+    });
+  }
+
+  bool
+  Client::perform_tree_upload(TreeTransfer& transfer) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto resource_urn = Path((root_urn + transfer.item->remote).path(), transfer.item->is_directory);
+
+    if (transfer.item->is_directory)
+    {
+      return is_collection(this->perform_create_directory(resource_urn, transfer.connection));
+    }
+
+    Request request(*this->config, *transfer.connection);
+
+    auto url = make_url(this->webdav_hostname, resource_urn);
+
+    const auto& local_file = transfer.item->local;
+    std::ifstream file_stream(local_file, std::ios::binary);
+    if (!file_stream.is_open()) return false;
+    auto size = FileInfo::size(local_file);
+
+    dict_t headers;
+
+    Scratch scratch;
+    auto& response = scratch.data();
+
+    request.set(CURLOPT_UPLOAD, 1L);
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_READDATA, reinterpret_cast<size_t>(&file_stream));
+    request.set(CURLOPT_READFUNCTION, reinterpret_cast<size_t>(Callback::Read::stream));
+    request.set(CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(size));
+    request.set(CURLOPT_BUFFERSIZE, static_cast<long>(Client::buffer_size));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&response));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    if (transfer.tree->is_reported())
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(Tree::progress));
+      request.set(CURLOPT_XFERINFODATA, reinterpret_cast<size_t>(&transfer));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
+
+    bool is_performed = request.perform();
+    uploaded(this->cache, resource_urn, is_performed, headers, size);
+    return is_performed;
+  }
+
+  bool
+  Client::sync(
+    const std::string& remote_directory,
+    const std::string& local_directory,
+    SyncPlan& plan,
+    bool is_dry_run,
+    size_t parallelism,
+    tree_progress_t progress
+  ) const
+  {
+    plan = SyncPlan{ {}, 0, 0, 0, 0, 0 };
+
+    auto root_urn = Path(this->webdav_root, true);
+    auto directory_urn = Path((root_urn + remote_directory).path(), true);
+    auto origin = this->webdav_hostname + directory_urn.path();
+
+    Sync::Session session;
+    session.remote_directory = remote_directory;
+    session.local_directory = local_directory;
+    session.actions = &plan.actions;
+
+    // the last listing is brought up to date with the changes since then
+    std::string sync_token;
+    std::string base_token;
+    Sync::load(local_directory, Sync::listing_file, origin, session.remote, sync_token);
+    Sync::load(local_directory, Sync::state_file, origin, session.base, base_token);
+
+    Connection connection;
+    if (!this->crawl(session, connection, sync_token, plan.scan_requests)) return false;
+    if (!Sync::scan(local_directory, session.local)) return false;
+
+    plan.actions = Sync::plan(session.local, session.remote, session.base);
+    Sync::estimate(plan);
+    if (is_dry_run) return true;
+
+    if (!FileInfo::create_directory(local_directory)) return false;
+    if (!this->create_directory(remote_directory, true)) return false;
+
+    // created directories go first, an action waits for the nearest
+    // directory above it which is created as well
+    Tree::items_t items;
+    std::map<std::string, size_t, Sync::Less> created;
+    for (bool is_creation : { true, false })
+    {
+      for (size_t index = 0; index < plan.actions.size(); ++index)
+      {
+        const auto& action = plan.actions[index];
+        bool is_created = action.kind == SyncAction::create_remote_directory ||
+                          action.kind == SyncAction::create_local_directory;
+        if (action.kind == SyncAction::conflict || is_created != is_creation) continue;
+
+        const auto& path = action.destination.empty() ? action.path : action.destination;
+        auto parent = TreeItem::none;
+        for (auto separator = path.rfind('/'); separator != std::string::npos && separator != 0;
+             separator = path.rfind('/', separator - 1))
+        {
+          auto it = created.find(path.substr(0, separator));
+          if (it == created.end()) continue;
+          parent = it->second;
+          break;
+        }
+
+        items.emplace_back(action.path, local_directory + "/" + action.path, is_created, parent);
+        session.indexes.push_back(index);
+        if (is_created) created[action.path] = items.size() - 1;
+      }
+    }
+    session.results.resize(plan.actions.size(), Sync::State{ false, std::string{}, 0, 0 });
+
+    Tree tree(std::move(items), std::move(progress));
+    bool is_done = tree.run(parallelism, [this, &session](TreeTransfer & transfer)
+    {
+      return this->perform_sync(transfer, session);
+    });
+
+    // the actions which turned into conflicts are counted too
+    Sync::estimate(plan);
+    bool is_saved = Sync::save(local_directory, Sync::state_file, origin, Sync::update(session), std::string{}) &&
+                    Sync::save(local_directory, Sync::listing_file, origin, session.remote, sync_token);
+    return is_done && is_saved && plan.conflicts == 0;
+  }
+
+  bool
+  Client::crawl(Sync::Session& session, const Connection& connection, std::string& sync_token, size_t& requests) const
+  {
+    // the changes since the last listing are applied to it, an empty token lists everything
+    bool is_listed_anew = sync_token.empty();
+    std::map<std::string, dict_t> changed;
+    strings_t removed;
+    if (this->perform_changes(session.remote_directory, sync_token, changed, removed, &connection, requests))
+    {
+      if (is_listed_anew) session.remote.clear();
+      for (auto& path : removed)
+      {
+        if (!path.empty() && path.back() == '/') path.pop_back();
+        auto it = session.remote.find(path);
+        while (it != session.remote.end() && (it->first == path || Sync::is_below(it->first, path)))
+        {
+          it = session.remote.erase(it);
+        }
+      }
+      for (auto& item : changed)
+      {
+        auto path = item.first;
+        bool is_directory = path.back() == '/';
+        if (is_directory) path.pop_back();
+        // the version of a directory is kept only if it covers everything beneath it
+        auto etag = is_directory && !this->is_etag_recursive ? std::string{} : item.second["etag"];
+        session.remote[path] = Sync::State{ is_directory, etag, get_number(item.second, "size", 0), 0 };
+      }
+      return true;
+    }
+
+    // a server which does not report changes is listed directory by directory,
+    // a listing of every directory carries all that is compared,
+    // the requests reuse one connection; a directory which has the same
+    // version as in the last listing is not listed again, its subtree is taken from there
+    auto listing = std::move(session.remote);
+    session.remote.clear();
+    auto root_urn = Path(this->webdav_root, true);
+
+    static const char body[] =
+      "<?xml version=\"1.0\"?>"
+      "<D:propfind xmlns:D=\"DAV:\" xmlns:CS=\"http://calendarserver.org/ns/\"><D:prop>"
+      "<D:resourcetype/><D:getcontentlength/><D:getlastmodified/><D:getetag/><CS:getctag/>"
+      "</D:prop></D:propfind>";
+
+    Header header(Headers::listing(), { "Content-Type: text/xml" });
+
+    std::deque<std::string> directories{ std::string{} };
+    while (!directories.empty())
+    {
+      auto directory = std::move(directories.front());
+      directories.pop_front();
+
+      auto target_urn = Path((root_urn + (session.remote_directory + "/" + directory)).path(), true);
+
+      Scratch scratch;
+      auto& data = scratch.data();
+
+      Request request(*this->config, connection);
+
+      auto url = make_url(this->webdav_hostname, target_urn);
+
+      request.set(CURLOPT_CUSTOMREQUEST, "PROPFIND");
+      request.set(CURLOPT_URL, url.c_str());
+      request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+      request.set(CURLOPT_POSTFIELDS, body);
+      request.set(CURLOPT_POSTFIELDSIZE, static_cast<long>(sizeof(body) - 1));
+      request.set(CURLOPT_HEADER, 0);
+      request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
+      request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
+#ifdef WDC_VERBOSE
+      request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+      ++requests;
+      bool is_performed = request.perform();
+      // a remote directory which does not exist yet is empty
+      if (!is_performed && directory.empty() && request.status() == 404) return true;
+      if (!is_performed) return false;
+
+      auto prefix = directory.empty() ? directory : directory + "/";
+
+      pugi::xml_document document;
+      document.load_buffer_inplace(data.buffer, static_cast<size_t>(data.size));
+      auto multistatus = document.select_node("*[local-name()='multistatus']").node();
+      auto responses = multistatus.select_nodes("*[local-name()='response']");
+      for (auto response : responses)
+      {
+        boost::string_view resource_path;
+        if (!decode_href(response.node(), resource_path)) continue;
+        Path resource_urn(resource_path);
+        if (resource_urn == target_urn) continue;
+
+        auto name = resource_urn.name_view();
+        if (name.empty() || name == "." || name == "..") continue;
+
+        auto resource_information = information(response.node());
+        bool is_directory = resource_urn.is_directory() ||
+                            resource_information["type"].find("collection") != std::string::npos;
+        auto path = prefix + std::string(name.data(), name.length());
+        auto etag = resource_information["etag"];
+        if (is_directory)
+        {
+          // getctag changes with anything beneath a directory, its ETag does so only on some servers
+          auto version = ctag(response.node());
+          etag = version.empty() && this->is_etag_recursive ? etag : version;
+        }
+        session.remote[path] = Sync::State{ is_directory, etag, get_number(resource_information, "size", 0), 0 };
+        if (!is_directory) continue;
+
+        auto known = listing.find(path);
+        bool is_unchanged = !etag.empty() && known != listing.end() && known->second.is_directory && known->second.etag == etag;
+        if (!is_unchanged)
+        {
+          directories.push_back(std::move(path));
+          continue;
+        }
+        for (auto it = std::next(known); it != listing.end() && Sync::is_below(it->first, path); ++it)
+        {
+          session.remote.insert(*it);
+        }
+      }
+    }
+    return true;
+  }
+
+  bool
+  Client::perform_sync(TreeTransfer& transfer, Sync::Session& session) const
+  {
+    auto& action = (*session.actions)[session.indexes[transfer.index]];
+    auto& result = session.results[session.indexes[transfer.index]];
+
+    switch (action.kind)
+    {
+      case SyncAction::upload:
+        action.is_done = this->perform_sync_upload(transfer, session, action);
+        break;
+      case SyncAction::download:
+        action.is_done = this->perform_sync_download(transfer, session, action);
+        break;
+      case SyncAction::create_remote_directory:
+      {
+        auto root_urn = Path(this->webdav_root, true);
+        auto directory_urn = Path((root_urn + (session.remote_directory + "/" + action.path)).path(), true);
+        action.is_done = is_collection(this->perform_create_directory(directory_urn, transfer.connection));
+        result = Sync::State{ true, std::string{}, 0, 0 };
+        break;
+      }
+      case SyncAction::create_local_directory:
+        action.is_done = FileInfo::create_directory(transfer.item->local);
+        result = Sync::State{ true, std::string{}, 0, 0 };
+        break;
+      case SyncAction::remove_remote:
+      case SyncAction::remove_local:
+        action.is_done = this->perform_sync_remove(transfer, session, action);
+        break;
+      case SyncAction::move_remote:
+      case SyncAction::move_local:
+        action.is_done = this->perform_sync_move(transfer, session, action);
+        break;
+      case SyncAction::compare:
+        action.is_done = this->perform_sync_compare(transfer, session, action);
+        break;
+      case SyncAction::conflict:
+        break;
+    }
+    return action.is_done;
+  }
+
+  bool
+  Client::perform_sync_upload(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + (session.remote_directory + "/" + action.path);
+
+    const auto& local_file = transfer.item->local;
+    auto& result = session.results[session.indexes[transfer.index]];
+    result = Sync::State{ false, std::string{}, 0, 0 };
+    if (!FileInfo::status(local_file, result.size, result.modified)) return false;
+
+    std::ifstream file_stream(local_file, std::ios::binary);
+    if (!file_stream.is_open()) return false;
+
+    // the remote file is replaced only as it was listed,
+    // a new one is not put over a file which has appeared meanwhile
+    Header header(Headers::accept(), {});
+    auto remote = session.remote.find(action.path);
+    if (remote == session.remote.end()) header.append("If-None-Match: *");
+    else if (!remote->second.etag.empty()) header.append("If-Match: " + remote->second.etag);
+
+    dict_t headers;
+
+    Scratch scratch;
+    auto& response = scratch.data();
+
+    Request request(*this->config, *transfer.connection);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    request.set(CURLOPT_UPLOAD, 1L);
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_READDATA, reinterpret_cast<size_t>(&file_stream));
+    request.set(CURLOPT_READFUNCTION, reinterpret_cast<size_t>(Callback::Read::stream));
+    request.set(CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(result.size));
+    request.set(CURLOPT_BUFFERSIZE, static_cast<long>(Client::buffer_size));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&response));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    if (transfer.tree->is_reported())
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(Tree::progress));
+      request.set(CURLOPT_XFERINFODATA, reinterpret_cast<size_t>(&transfer));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
+
+    bool is_performed = request.perform();
+    uploaded(this->cache, file_urn, is_performed, headers, result.size);
+    if (!is_performed)
+    {
+      if (request.status() == 412) action.kind = SyncAction::conflict;
+      return false;
+    }
+
+    // not every server answers a PUT with the ETag
+    result.etag = get(headers, "etag");
+    if (result.etag.empty()) result.etag = this->etag(session.remote_directory + "/" + action.path);
+    return true;
+  }
+
+  bool
+  Client::perform_sync_download(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + (session.remote_directory + "/" + action.path);
 
-    Data data = { nullptr, 0, 0 };
+    const auto& local_file = transfer.item->local;
+    auto partial_file = FileInfo::temporary(local_file);
+    std::ofstream file_stream(partial_file, std::ios::binary);
+    if (!file_stream.is_open()) return false;
 
-    Request request(this->options());
+    dict_t headers;
 
-    auto url = this->webdav_hostname + target_urn.quote(request.handle);
+    Request request(*this->config, *transfer.connection);
 
-    request.set(CURLOPT_CUSTOMREQUEST, "PROPFIND");
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
     request.set(CURLOPT_URL, url.c_str());
-    request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
-    request.set(CURLOPT_HEADER, 0);
-    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&data));
-    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Append::buffer));
+    request.set(CURLOPT_HEADER, 0L);
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&file_stream));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Write::stream));
 #ifdef WDC_VERBOSE
     request.set(CURLOPT_VERBOSE, 1);
 #endif
+    if (transfer.tree->is_reported())
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(Tree::progress));
+      request.set(CURLOPT_XFERINFODATA, reinterpret_cast<size_t>(&transfer));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
 
     bool is_performed = request.perform();
+    file_stream.close();
 
-    if (!is_performed) return strings_t{};
+    if (!is_performed || file_stream.fail())
+    {
+      std::remove(partial_file.c_str());
+      return false;
+    }
 
-    strings_t resources;
+    // the local file is replaced only as it was scanned
+    Sync::State state{ false, std::string{}, 0, 0 };
+    bool is_existed = FileInfo::status(local_file, state.size, state.modified);
+    auto local = session.local.find(action.path);
+    bool is_untouched = local == session.local.end() ?
+                        !is_existed :
+                        is_existed && state.size == local->second.size && state.modified == local->second.modified;
+    if (!is_untouched)
+    {
+      std::remove(partial_file.c_str());
+      action.kind = SyncAction::conflict;
+      return false;
+    }
 
-    pugi::xml_document document;
-    document.load_buffer(data.buffer, static_cast<size_t>(data.size));
-    auto multistatus = document.select_node("*[local-name()='multistatus']").node();
-    auto responses = multistatus.select_nodes("*[local-name()='response']");
-    for (auto response : responses)
+    if (!FileInfo::replace(partial_file, local_file))
     {
-      pugi::xml_node href = response.node().select_node("*[local-name()='href']").node();
-      std::string encode_file_name = href.first_child().value();
-      std::string resource_path = curl_unescape(encode_file_name.c_str(), static_cast<int>(encode_file_name.length()));
-      auto target_path = target_urn.path();
-      Path resource_urn(resource_path);
-      if (resource_urn == target_urn) continue;
-      resources.push_back(resource_urn.name());
+      std::remove(partial_file.c_str());
+      return false;
     }
 
-    return resources;
-  }
+    downloaded(this->cache, file_urn, headers);
 
-  bool Client::download(
-    const std::string& remote_file,
-    const std::string& local_file,
-    progress_t progress
-  ) const
-  {
-    return this->sync_download(remote_file, local_file, nullptr, std::move(progress));
+    auto& result = session.results[session.indexes[transfer.index]];
+    result = Sync::State{ false, get(headers, "etag"), 0, 0 };
+    if (result.etag.empty()) result.etag = session.remote.at(action.path).etag;
+    return FileInfo::status(local_file, result.size, result.modified);
   }
 
-  void
-  Client::async_download(
-    const std::string& remote_file,
-    const std::string& local_file,
-    callback_t callback,
-    progress_t progress
-  ) const
+  bool
+  Client::perform_sync_remove(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const
   {
-    std::thread downloading([ = ]()
+    if (action.kind == SyncAction::remove_local)
     {
-      this->sync_download(remote_file, local_file, callback, std::move(progress));
-    });
-    downloading.detach();
+      // the local file or directory is removed only as it was scanned
+      Sync::State state{ false, std::string{}, 0, 0 };
+      if (!FileInfo::status(transfer.item->local, state.size, state.modified)) return true;
+      if (action.is_directory)
+      {
+        bool is_changed = false;
+        if (Sync::remove_scanned(session.local_directory, action.path, session.local, is_changed)) return true;
+        if (is_changed) action.kind = SyncAction::conflict;
+        return false;
+      }
+
+      const auto& local = session.local.at(action.path);
+      if (state.size != local.size || state.modified != local.modified)
+      {
+        action.kind = SyncAction::conflict;
+        return false;
+      }
+      return std::remove(transfer.item->local.c_str()) == 0;
+    }
+
+    auto root_urn = Path(this->webdav_root, true);
+    auto resource_urn = Path((root_urn + (session.remote_directory + "/" + action.path)).path(), action.is_directory);
+
+    // the remote file is removed only as it was listed
+    Header header(Headers::keep_alive(), {});
+    const auto& etag = session.remote.at(action.path).etag;
+    if (!action.is_directory && !etag.empty()) header.append("If-Match: " + etag);
+
+    Request request(*this->config, *transfer.connection);
+
+    auto url = make_url(this->webdav_hostname, resource_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "DELETE");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+    bool is_performed = request.perform();
+    forget(this->cache, resource_urn);
+    this->directories->erase_tree(Cache::key(resource_urn.path()));
+    if (request.status() == 412) action.kind = SyncAction::conflict;
+    return is_performed || request.status() == 404;
   }
 
   bool
-  Client::download_to(
-    const std::string& remote_file,
-    char*& buffer_ptr,
-    unsigned long long& buffer_size,
-    progress_t progress
-  ) const
+  Client::perform_sync_move(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const
   {
-    return this->sync_download_to(remote_file, buffer_ptr, buffer_size, nullptr, std::move(progress));
+    auto& result = session.results[session.indexes[transfer.index]];
+    auto destination_file = session.local_directory + "/" + action.destination;
+    result = Sync::State{ false, std::string{}, 0, 0 };
+
+    if (action.kind == SyncAction::move_local)
+    {
+      // neither the moved file nor the destination may have changed since the scan
+      Sync::State state{ false, std::string{}, 0, 0 };
+      const auto& local = session.local.at(action.path);
+      bool is_untouched = FileInfo::status(transfer.item->local, state.size, state.modified) &&
+                          state.size == local.size && state.modified == local.modified &&
+                          !FileInfo::status(destination_file, state.size, state.modified);
+      if (!is_untouched)
+      {
+        action.kind = SyncAction::conflict;
+        return false;
+      }
+      if (std::rename(transfer.item->local.c_str(), destination_file.c_str()) != 0) return false;
+
+      result.etag = session.remote.at(action.destination).etag;
+      return FileInfo::status(destination_file, result.size, result.modified);
+    }
+
+    auto root_urn = Path(this->webdav_root, true);
+    auto source_urn = root_urn + (session.remote_directory + "/" + action.path);
+    auto destination_urn = root_urn + (session.remote_directory + "/" + action.destination);
+
+    // a file which has appeared at the destination meanwhile is not overwritten
+    Header header(Headers::keep_alive(),
+    {
+      "Destination: " + destination_urn.quote(),
+      "Overwrite: F"
+    });
+
+    Request request(*this->config, *transfer.connection);
+
+    auto url = make_url(this->webdav_hostname, source_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "MOVE");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+    bool is_performed = request.perform();
+    forget(this->cache, source_urn);
+    forget(this->cache, destination_urn);
+    if (!is_performed)
+    {
+      if (request.status() == 412) action.kind = SyncAction::conflict;
+      return false;
+    }
+
+    // servers differ in whether a moved file keeps its ETag
+    result.etag = this->etag(session.remote_directory + "/" + action.destination);
+    return FileInfo::status(destination_file, result.size, result.modified);
   }
 
   bool
-  Client::download_to(
-    const std::string& remote_file,
-    std::ostream& stream,
-    progress_t progress
-  ) const
+  Client::perform_sync_compare(TreeTransfer& transfer, Sync::Session& session, SyncAction& action) const
   {
-    return this->sync_download_to(remote_file, stream, nullptr, std::move(progress));
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + (session.remote_directory + "/" + action.path);
+
+    const auto& local_file = transfer.item->local;
+    std::ifstream file_stream(local_file, std::ios::binary);
+    if (!file_stream.is_open()) return false;
+
+    dict_t headers;
+
+    Request request(*this->config, *transfer.connection);
+
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADER, 0L);
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&file_stream));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Compare::stream));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+    if (transfer.tree->is_reported())
+    {
+      request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(Tree::progress));
+      request.set(CURLOPT_XFERINFODATA, reinterpret_cast<size_t>(&transfer));
+      request.set(CURLOPT_NOPROGRESS, 0L);
+    }
+
+    bool is_performed = request.perform();
+
+    // the files differ if the local one has other bytes or more of them,
+    // a body of an error is not the content of the remote file
+    auto status = request.status();
+    bool is_different = status >= 200 && status < 300 &&
+                        (file_stream.fail() || (is_performed && file_stream.peek() != std::char_traits<char>::eof()));
+    if (is_different)
+    {
+      action.kind = SyncAction::conflict;
+      return false;
+    }
+    if (!is_performed) return false;
+
+    // the local file must not have changed while it was compared
+    auto& result = session.results[session.indexes[transfer.index]];
+    result = Sync::State{ false, get(headers, "etag"), 0, 0 };
+    if (result.etag.empty()) result.etag = session.remote.at(action.path).etag;
+    if (!FileInfo::status(local_file, result.size, result.modified)) return false;
+    const auto& local = session.local.at(action.path);
+    if (result.size != local.size || result.modified != local.modified)
+    {
+      action.kind = SyncAction::conflict;
+      return false;
+    }
+    return true;
   }
 
   bool
   Client::create_directory(const std::string& remote_directory, bool recursive) const
   {
-    bool is_existed = this->check(remote_directory);
-    if (is_existed) return true;
+    auto root_urn = Path(this->webdav_root, true);
+    auto target_urn = Path((root_urn + remote_directory).path(), true);
+    if (this->directories->contains(Cache::key(target_urn.path()))) return true;
+
+    // the leaf is tried first, usually its parent exists
+    auto status = this->perform_create_directory(target_urn);
+    if (status != 409 || !recursive) return is_collection(status);
+
+    // 409 Conflict: the parent is missing, even if it was known to exist;
+    // ancestors are created top-down below the deepest one known to exist,
+    // if that one has been removed meanwhile the whole chain is created
+    this->directories->erase_tree(Cache::key(target_urn.parent().path()));
+    for (bool is_known_trusted : { true, false })
+    {
+      std::vector<Path> ancestors;
+      for (auto urn = target_urn.parent(); !urn.is_root() && !(urn == root_urn); urn = urn.parent())
+      {
+        if (is_known_trusted && this->directories->contains(Cache::key(urn.path()))) break;
+        ancestors.push_back(urn);
+      }
 
-    bool resource_is_dir = true;
-    Path directory_urn(remote_directory, resource_is_dir);
+      auto ancestor = ancestors.rbegin();
+      for (; ancestor != ancestors.rend(); ++ancestor)
+      {
+        status = this->perform_create_directory(*ancestor);
+        if (!is_collection(status)) break;
+      }
+      if (ancestor == ancestors.rend()) return is_collection(this->perform_create_directory(target_urn));
+      if (status != 409) return false;
 
-    if (recursive)
-    {
-      auto remote_parent_directory = directory_urn.parent().path();
-      if (remote_parent_directory == remote_directory) return false;
-      bool is_created = this->create_directory(remote_parent_directory, true);
-      if (!is_created) return false;
+      this->directories->erase_tree(Cache::key(ancestor->parent().path()));
     }
+    return false;
+  }
 
-    Header header =
-    {
-      "Accept: */*",
-      "Connection: Keep-Alive"
-    };
-
-    auto target_urn = Path(this->webdav_root, true) + remote_directory;
-    target_urn = Path(target_urn.path(), true);
+  long
+  Client::perform_create_directory(const Path& directory_urn, const Connection* connection) const
+  {
+    const auto& header = Headers::keep_alive();
 
-    Request request(this->options());
+    auto request = connection == nullptr ? Request(*this->config) : Request(*this->config, *connection);
 
-    auto url = this->webdav_hostname + target_urn.quote(request.handle);
+    auto url = make_url(this->webdav_hostname, directory_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "MKCOL");
     request.set(CURLOPT_URL, url.c_str());
@@ -638,7 +2200,11 @@ namespace WebDAV
     request.set(CURLOPT_VERBOSE, 1);
 #endif
 
-    return request.perform();
+    request.perform();
+    auto status = request.status();
+    if (is_collection(status)) this->directories->insert(Cache::key(directory_urn.path()));
+    forget(this->cache, directory_urn);
+    return status;
   }
 
   bool
@@ -652,15 +2218,14 @@ namespace WebDAV
     auto source_resource_urn = root_urn + remote_source_resource;
     auto destination_resource_urn = root_urn + remote_destination_resource;
 
-    Header header =
+    Header header(Headers::accept(),
     {
-      "Accept: */*",
       "Destination: " + destination_resource_urn.path()
-    };
+    });
 
-    Request request(this->options());
+    Request request(*this->config);
 
-    auto url = this->webdav_hostname + source_resource_urn.quote(request.handle);
+    auto url = make_url(this->webdav_hostname, source_resource_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "MOVE");
     request.set(CURLOPT_URL, url.c_str());
@@ -669,7 +2234,12 @@ namespace WebDAV
     request.set(CURLOPT_VERBOSE, 1);
 #endif
 
-    return request.perform();
+    bool is_performed = request.perform();
+    forget(this->cache, source_resource_urn);
+    forget(this->cache, destination_resource_urn);
+    this->directories->erase_tree(Cache::key(source_resource_urn.path()));
+    this->directories->erase_tree(Cache::key(destination_resource_urn.path()));
+    return is_performed;
   }
 
   bool
@@ -683,15 +2253,14 @@ namespace WebDAV
     auto source_resource_urn = root_urn + remote_source_resource;
     auto destination_resource_urn = root_urn + remote_destination_resource;
 
-    Header header =
+    Header header(Headers::accept(),
     {
-      "Accept: */*",
       "Destination: " + destination_resource_urn.path()
-    };
+    });
 
-    Request request(this->options());
+    Request request(*this->config);
 
-    auto url = this->webdav_hostname + source_resource_urn.quote(request.handle);
+    auto url = make_url(this->webdav_hostname, source_resource_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "COPY");
     request.set(CURLOPT_URL, url.c_str());
@@ -700,7 +2269,11 @@ namespace WebDAV
     request.set(CURLOPT_VERBOSE, 1);
 #endif
 
-    return request.perform();
+    bool is_performed = request.perform();
+    forget(this->cache, destination_resource_urn);
+    // the copy replaces the subdirectories of the destination
+    this->directories->erase_tree(Cache::key(destination_resource_urn.path()));
+    return is_performed;
   }
 
   bool
@@ -713,6 +2286,17 @@ namespace WebDAV
     return this->sync_upload(remote_file, local_file, nullptr, std::move(progress));
   }
 
+  bool
+  Client::upload(
+    const std::string& remote_file,
+    const std::string& local_file,
+    dict_t& information,
+    progress_t progress
+  ) const
+  {
+    return this->sync_upload(remote_file, local_file, nullptr, std::move(progress), &information);
+  }
+
   void
   Client::async_upload(
     const std::string& remote_file,
@@ -749,6 +2333,16 @@ namespace WebDAV
     return this->sync_upload_from(remote_file, buffer_ptr, buffer_size, nullptr, std::move(progress));
   }
 
+  bool
+  Client::upload_from(
+    const std::string& remote_file,
+    const segments_t& segments,
+    progress_t progress
+  ) const
+  {
+    return this->sync_upload_from(remote_file, segments, nullptr, std::move(progress));
+  }
+
   bool
   Client::clean(const std::string& remote_resource) const
   {
@@ -758,15 +2352,11 @@ namespace WebDAV
     auto root_urn = Path(this->webdav_root, true);
     auto resource_urn = root_urn + remote_resource;
 
-    Header header =
-    {
-      "Accept: */*",
-      "Connection: Keep-Alive"
-    };
+    const auto& header = Headers::keep_alive();
 
-    Request request(this->options());
+    Request request(*this->config);
 
-    auto url = this->webdav_hostname + resource_urn.quote(request.handle);
+    auto url = make_url(this->webdav_hostname, resource_urn);
 
     request.set(CURLOPT_CUSTOMREQUEST, "DELETE");
     request.set(CURLOPT_URL, url.c_str());
@@ -775,7 +2365,156 @@ namespace WebDAV
     request.set(CURLOPT_VERBOSE, 1);
 #endif
 
-    return request.perform();
+    bool is_performed = request.perform();
+    forget(this->cache, resource_urn);
+    this->directories->erase_tree(Cache::key(resource_urn.path()));
+    return is_performed;
+  }
+
+  void
+  Client::prefetch(const strings_t& remote_files) const
+  {
+    if (this->prefetcher == nullptr) return;
+
+    // the background copy must not own the prefetcher it runs in
+    auto background = *this;
+    background.prefetcher.reset();
+    auto prefetcher = this->prefetcher.get();
+
+    for (const auto& remote_file : remote_files)
+    {
+      this->prefetcher->schedule([background, remote_file, prefetcher]()
+      {
+        background.perform_prefetch(remote_file, *prefetcher);
+      });
+    }
+  }
+
+  void
+  Client::perform_prefetch(const std::string& remote_file, Prefetcher& prefetcher) const
+  {
+    auto root_urn = Path(this->webdav_root, true);
+    auto file_urn = root_urn + remote_file;
+
+    std::ostringstream stream;
+    dict_t headers;
+
+    Request request(*this->config);
+    request.make_background();
+
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADER, 0L);
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&stream));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Write::stream));
+    request.set(CURLOPT_XFERINFODATA, reinterpret_cast<size_t>(&prefetcher));
+    request.set(CURLOPT_XFERINFOFUNCTION, reinterpret_cast<size_t>(Prefetcher::abort));
+    request.set(CURLOPT_NOPROGRESS, 0L);
+    request.set(CURLOPT_MAXFILESIZE_LARGE, static_cast<curl_off_t>(prefetcher.size_limit));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+    bool is_performed = request.perform();
+    if (!is_performed) return;
+
+    auto etag = get(headers, "etag");
+    if (etag.empty()) return;
+    prefetcher.put(Cache::key(file_urn.path()), etag, stream.str());
+  }
+
+  bool
+  Client::prefetched(const std::string& remote_file, std::string& content) const
+  {
+    if (this->prefetcher == nullptr || this->cache == nullptr) return false;
+
+    auto file_urn = Path(this->webdav_root, true) + remote_file;
+    auto key = Cache::key(file_urn.path());
+
+    // prefetched content is served only while it matches the cached metadata
+    dict_t cached_information;
+    if (!this->cache->information(key, cached_information)) return false;
+    return this->prefetcher->find(key, get(cached_information, "etag"), content);
+  }
+
+  RemoteFile
+  Client::open(const std::string& remote_file, size_t block_size, size_t cache_size) const
+  {
+    auto file_urn = Path(this->webdav_root, true) + remote_file;
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    std::unique_ptr<Reader> reader{ new Reader{ this->config, url, block_size, cache_size } };
+    if (!reader->open()) reader.reset();
+    return RemoteFile{ std::move(reader) };
+  }
+
+  RemoteStream
+  Client::open_stream(const std::string& remote_file, size_t buffer_size) const
+  {
+    auto file_urn = Path(this->webdav_root, true) + remote_file;
+
+    Request request(*this->config);
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
+    request.set(CURLOPT_URL, url.c_str());
+    request.set(CURLOPT_HEADER, 0L);
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+    std::unique_ptr<Fetcher> fetcher{ new Fetcher{ std::move(request), buffer_size } };
+    return RemoteStream{ std::move(fetcher) };
+  }
+
+  RemoteWriter
+  Client::open_writer(const std::string& remote_file, long long file_size, size_t buffer_size) const
+  {
+    auto file_urn = Path(this->webdav_root, true) + remote_file;
+
+    Request request(*this->config);
+    auto url = make_url(this->webdav_hostname, file_urn);
+
+    // the data are sent at once, without waiting for 100 Continue
+    Header header =
+    {
+      "Expect:"
+    };
+    if (file_size < 0) header.append("Transfer-Encoding: chunked");
+
+    request.set(CURLOPT_URL, url.c_str());
+    if (file_size >= 0) request.set(CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(file_size));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+    auto cache = this->cache;
+    auto completion = [cache, file_urn](bool is_performed, const dict_t & headers, unsigned long long size)
+    {
+      uploaded(cache, file_urn, is_performed, headers, size);
+    };
+
+    std::unique_ptr<Sender> sender{ new Sender{ std::move(request), std::move(header), buffer_size, completion } };
+    return RemoteWriter{ std::move(sender) };
+  }
+
+  bool
+  Client::reload_certificate() const
+  {
+    return this->config->reload_certificate();
+  }
+
+  void
+  Client::invalidate(const std::string& remote_resource) const
+  {
+    auto resource_urn = Path(this->webdav_root, true) + remote_resource;
+    this->directories->erase_tree(Cache::key(resource_urn.path()));
+    if (this->cache == nullptr) return;
+    this->cache->invalidate_tree(Cache::key(resource_urn.path()));
   }
 
   class Environment
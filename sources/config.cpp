@@ -0,0 +1,90 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "config.hpp"
+#include "fsinfo.hpp"
+
+#include <fstream>
+#include <iterator>
+
+namespace WebDAV
+{
+  auto inline get(const dict_t& options, const std::string&& name) -> std::string
+  {
+    auto it = options.find(name);
+    if (it == options.end()) return "";
+    else return it->second;
+  }
+
+  auto inline read(const std::string& path, std::string& content) -> bool
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+  }
+
+  Config::Config(const dict_t& options) :
+    hostname(get(options, "webdav_hostname")),
+    credentials(get(options, "webdav_username") + ":" + get(options, "webdav_password")),
+    is_proxy_enabled(false),
+    proxy_hostname(get(options, "proxy_hostname")),
+    cert_path(get(options, "cert_path")),
+    key_path(get(options, "key_path"))
+  {
+    auto proxy_username = get(options, "proxy_username");
+    auto proxy_password = get(options, "proxy_password");
+
+    // a password without a user name disables the proxy
+    bool is_proxy_valid = proxy_username.empty() ? proxy_password.empty() : true;
+    this->is_proxy_enabled = !this->proxy_hostname.empty() && is_proxy_valid;
+    if (this->is_proxy_enabled && !proxy_username.empty())
+    {
+      if (proxy_password.empty()) this->proxy_username = proxy_username;
+      else this->proxy_credentials = proxy_username + ":" + proxy_password;
+    }
+
+    this->reload_certificate();
+  }
+
+  auto Config::certificate() const -> std::shared_ptr<const Certificate>
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->loaded_certificate;
+  }
+
+  auto Config::reload_certificate() -> bool
+  {
+    // the files may appear after the construction, e.g. on the first rotation
+    if (this->cert_path.empty() || this->key_path.empty()) return false;
+    if (!FileInfo::exists(this->cert_path) || !FileInfo::exists(this->key_path)) return false;
+
+    // requests in flight keep the certificate they were configured with
+    std::shared_ptr<Certificate> certificate = std::make_shared<Certificate>();
+    if (!read(this->cert_path, certificate->cert)) return false;
+    if (!read(this->key_path, certificate->key)) return false;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->loaded_certificate = std::move(certificate);
+    return true;
+  }
+} // namespace WebDAV
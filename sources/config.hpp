@@ -0,0 +1,76 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_CONFIG_HPP
+#define WEBDAV_CONFIG_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace WebDAV
+{
+  using dict_t = std::map<std::string, std::string>;
+
+  ///
+  /// PEM encoded client certificate and its private key
+  ///
+  struct Certificate
+  {
+    std::string cert;
+    std::string key;
+  };
+
+  ///
+  /// Connection settings of a client, validated once at construction.
+  /// A Request is configured from it without lookups or file system checks.
+  /// The client certificate is read into memory and replaced only on reload.
+  ///
+  struct Config
+  {
+    explicit Config(const dict_t& options);
+
+    Config(const Config& other) = delete;
+    auto operator=(const Config& other) -> Config& = delete;
+
+    auto certificate() const -> std::shared_ptr<const Certificate>;
+    auto reload_certificate() -> bool;
+
+    std::string hostname;
+    std::string credentials;
+
+    bool is_proxy_enabled;
+    std::string proxy_hostname;
+    std::string proxy_username;
+    std::string proxy_credentials;
+
+    std::string cert_path;
+    std::string key_path;
+
+  private:
+    mutable std::mutex mutex;
+    std::shared_ptr<const Certificate> loaded_certificate;
+  };
+} // namespace WebDAV
+
+#endif
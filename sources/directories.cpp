@@ -0,0 +1,63 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "directories.hpp"
+
+namespace WebDAV
+{
+  using std::chrono::steady_clock;
+
+  Directories::Directories(std::chrono::milliseconds ttl_, size_t capacity) : ttl(ttl_), keys(capacity)
+  {
+  }
+
+  auto Directories::contains(const std::string& key) -> bool
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto expiration = this->keys.find(key);
+    if (expiration == nullptr) return false;
+    if (*expiration > steady_clock::now()) return true;
+
+    this->keys.erase(key);
+    return false;
+  }
+
+  auto Directories::insert(const std::string& key) -> void
+  {
+    if (this->ttl.count() <= 0) return;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->keys.insert(key, steady_clock::now() + this->ttl);
+  }
+
+  auto Directories::erase_tree(const std::string& key) -> void
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (key == "/") return this->keys.clear();
+
+    auto prefix = key + "/";
+    this->keys.erase_if([&key, &prefix](const std::string & item, const time_point&)
+    {
+      return item == key || item.compare(0, prefix.length(), prefix) == 0;
+    });
+  }
+} // namespace WebDAV
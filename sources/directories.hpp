@@ -0,0 +1,60 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_DIRECTORIES_HPP
+#define WEBDAV_DIRECTORIES_HPP
+
+#include "lru.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace WebDAV
+{
+  ///
+  /// Remote directories which are known to exist, so creating them again
+  /// or creating their subdirectories needs no requests for the ancestors.
+  /// Keys are normalized as Cache keys. A directory is remembered for ttl,
+  /// a zero ttl remembers nothing. A directory removed by another client
+  /// is noticed by the next MKCOL below it, which fails with 409.
+  ///
+  class Directories
+  {
+  public:
+    Directories(std::chrono::milliseconds ttl, size_t capacity);
+
+    auto contains(const std::string& key) -> bool;
+    auto insert(const std::string& key) -> void;
+    auto erase_tree(const std::string& key) -> void;
+
+  private:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    const std::chrono::milliseconds ttl;
+
+    std::mutex mutex;
+    Lru<std::string, time_point> keys;
+  };
+} // namespace WebDAV
+
+#endif
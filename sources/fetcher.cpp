@@ -0,0 +1,157 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "fetcher.hpp"
+
+#include <webdav/client.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace WebDAV
+{
+  Fetcher::Fetcher(Request&& request_, size_t buffer_size) :
+    request(std::move(request_)),
+    stream(nullptr),
+    multi_handle(curl_multi_init()),
+    buffer(std::max<size_t>(buffer_size, CURL_MAX_WRITE_SIZE)),
+    length(0),
+    is_paused(false),
+    is_running(true),
+    is_failed(false)
+  {
+    // a single chunk of the body never exceeds the buffer
+    this->request.set(CURLOPT_BUFFERSIZE, static_cast<long>(CURL_MAX_WRITE_SIZE));
+    this->request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(this));
+    this->request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Fetcher::write));
+    curl_multi_add_handle(this->multi_handle, this->request.handle);
+    this->setg(this->buffer.data(), this->buffer.data(), this->buffer.data());
+  }
+
+  Fetcher::~Fetcher()
+  {
+    curl_multi_remove_handle(this->multi_handle, this->request.handle);
+    curl_multi_cleanup(this->multi_handle);
+  }
+
+  auto Fetcher::attach(std::istream* stream_) -> void
+  {
+    this->stream = stream_;
+    if (this->is_failed && this->stream != nullptr) this->stream->setstate(std::ios::badbit);
+  }
+
+  auto Fetcher::status() const -> long
+  {
+    return this->request.status();
+  }
+
+  auto Fetcher::write(char* ptr, size_t item_size, size_t item_count, void* fetcher) -> size_t
+  {
+    auto self = reinterpret_cast<Fetcher*>(fetcher);
+    auto size = item_size * item_count;
+
+    // a body of an error response is not a content of the file
+    auto status = self->request.status();
+    if (status < 200 || status > 299) return 0;
+
+    if (size > self->buffer.size() - self->length)
+    {
+      self->is_paused = true;
+      return CURL_WRITEFUNC_PAUSE;
+    }
+
+    memcpy(self->buffer.data() + self->length, ptr, size);
+    self->length += size;
+    return size;
+  }
+
+  auto Fetcher::underflow() -> int_type
+  {
+    if (this->gptr() < this->egptr()) return traits_type::to_int_type(*this->gptr());
+
+    // the whole buffer is consumed, so it is filled from the beginning
+    this->length = 0;
+    if (this->is_paused)
+    {
+      this->is_paused = false;
+      curl_easy_pause(this->request.handle, CURLPAUSE_CONT);
+    }
+
+    while (this->length == 0 && this->is_running && !this->is_paused)
+    {
+      int running_handles = 0;
+      curl_multi_perform(this->multi_handle, &running_handles);
+      this->is_running = running_handles != 0;
+      if (this->length != 0 || !this->is_running) break;
+      curl_multi_wait(this->multi_handle, nullptr, 0, 1000, nullptr);
+    }
+
+    this->setg(this->buffer.data(), this->buffer.data(), this->buffer.data() + this->length);
+    if (this->length != 0) return traits_type::to_int_type(*this->gptr());
+
+    if (!this->is_running)
+    {
+      int messages_count = 0;
+      while (auto message = curl_multi_info_read(this->multi_handle, &messages_count))
+      {
+        auto status = this->request.status();
+        bool is_transfer_failed = message->msg == CURLMSG_DONE && message->data.result != CURLE_OK;
+        if (is_transfer_failed || status < 200 || status > 299) this->is_failed = true;
+      }
+      // the failure is not thrown, a reader of the buffer would not catch it
+      if (this->is_failed && this->stream != nullptr) this->stream->setstate(std::ios::badbit);
+    }
+    return traits_type::eof();
+  }
+
+  RemoteStream::RemoteStream(std::unique_ptr<Fetcher> fetcher_) : std::istream(nullptr), fetcher(std::move(fetcher_))
+  {
+    if (this->fetcher != nullptr)
+    {
+      this->rdbuf(this->fetcher.get());
+      this->fetcher->attach(this);
+    }
+  }
+
+  RemoteStream::RemoteStream(RemoteStream&& other) noexcept : std::istream(std::move(other)), fetcher(std::move(other.fetcher))
+  {
+    this->set_rdbuf(this->fetcher.get());
+    if (this->fetcher != nullptr) this->fetcher->attach(this);
+  }
+
+  RemoteStream::~RemoteStream() = default;
+
+  auto RemoteStream::operator=(RemoteStream&& other) noexcept -> RemoteStream&
+  {
+    std::istream::operator=(std::move(other));
+    this->fetcher = std::move(other.fetcher);
+    this->set_rdbuf(this->fetcher.get());
+    if (this->fetcher != nullptr) this->fetcher->attach(this);
+    return *this;
+  }
+
+  auto RemoteStream::status() const -> long
+  {
+    if (this->fetcher == nullptr) return 0;
+    return this->fetcher->status();
+  }
+} // namespace WebDAV
@@ -0,0 +1,69 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_FETCHER_HPP
+#define WEBDAV_FETCHER_HPP
+
+#include "request.hpp"
+
+#include <istream>
+#include <streambuf>
+#include <vector>
+
+namespace WebDAV
+{
+  ///
+  /// Stream buffer behind WebDAV::RemoteStream.
+  /// The body of a GET request is pulled into a fixed buffer on demand,
+  /// the transfer is paused while the buffer is full.
+  /// A failed transfer ends the buffer and sets badbit of the attached stream.
+  ///
+  class Fetcher : public std::streambuf
+  {
+  public:
+    Fetcher(Request&& request, size_t buffer_size);
+    ~Fetcher();
+
+    Fetcher(const Fetcher& other) = delete;
+    auto operator=(const Fetcher& other) -> Fetcher& = delete;
+
+    auto attach(std::istream* stream) -> void;
+    auto status() const -> long;
+
+  protected:
+    auto underflow() -> int_type override;
+
+  private:
+    static auto write(char* ptr, size_t item_size, size_t item_count, void* fetcher) -> size_t;
+
+    Request request;
+    std::istream* stream;
+    void* multi_handle;
+    std::vector<char> buffer;
+    size_t length;
+    bool is_paused;
+    bool is_running;
+    bool is_failed;
+  };
+} // namespace WebDAV
+
+#endif
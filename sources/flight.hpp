@@ -0,0 +1,104 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_FLIGHT_HPP
+#define WEBDAV_FLIGHT_HPP
+
+#include <exception>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WebDAV
+{
+  using dict_t = std::map<std::string, std::string>;
+  using strings_t = std::vector<std::string>;
+
+  ///
+  /// Coalesces concurrent identical requests: the first caller for a key
+  /// performs the request, callers arriving while it is in flight wait
+  /// for its result instead of issuing their own.
+  ///
+  template <typename Result>
+  class Flight
+  {
+  public:
+    template <typename Function>
+    auto share(const std::string& key, Function function) -> Result
+    {
+      std::promise<Result> promise;
+      std::shared_future<Result> future;
+      bool is_leader = false;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = flights.find(key);
+        if (it != flights.end())
+        {
+          future = it->second;
+        }
+        else
+        {
+          future = promise.get_future().share();
+          flights.emplace(key, future);
+          is_leader = true;
+        }
+      }
+
+      if (!is_leader) return future.get();
+
+      try
+      {
+        auto result = function();
+        this->land(key);
+        promise.set_value(result);
+        return result;
+      }
+      catch (...)
+      {
+        this->land(key);
+        promise.set_exception(std::current_exception());
+        throw;
+      }
+    }
+
+  private:
+    auto land(const std::string& key) -> void
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      flights.erase(key);
+    }
+
+    std::mutex mutex;
+    std::map<std::string, std::shared_future<Result>> flights;
+  };
+
+  struct Flights
+  {
+    Flight<bool> existence;
+    Flight<dict_t> information;
+    Flight<strings_t> resources;
+  };
+} // namespace WebDAV
+
+#endif
@@ -21,8 +21,20 @@
 ############################################################################*/
 
 #include "fsinfo.hpp"
+#include <atomic>
+#include <cstdio>
 #include <fstream>
 
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
 namespace WebDAV
 {
   namespace FileInfo
@@ -38,5 +50,114 @@ namespace WebDAV
       std::ifstream file(path_file, std::ios::binary | std::ios::ate);
       return static_cast<unsigned long long>(file.tellg());
     }
+
+    auto create_directory(const std::string& path) -> bool
+    {
+#ifdef _WIN32
+      if (_mkdir(path.c_str()) == 0) return true;
+#else
+      if (mkdir(path.c_str(), 0755) == 0) return true;
+#endif
+      struct stat status;
+      return stat(path.c_str(), &status) == 0 && (status.st_mode & S_IFMT) == S_IFDIR;
+    }
+
+    auto status(const std::string& path, unsigned long long& size, long long& modified) -> bool
+    {
+      struct stat status;
+      if (stat(path.c_str(), &status) != 0) return false;
+      size = static_cast<unsigned long long>(status.st_size);
+      modified = static_cast<long long>(status.st_mtime);
+      return true;
+    }
+
+    auto temporary(const std::string& path) -> std::string
+    {
+      static std::atomic<unsigned long> counter{ 0 };
+#ifdef _WIN32
+      auto process = static_cast<long>(_getpid());
+#else
+      auto process = static_cast<long>(getpid());
+#endif
+      return path + "." + std::to_string(process) + "-" + std::to_string(++counter) + ".part";
+    }
+
+    auto replace(const std::string& source, const std::string& destination) -> bool
+    {
+#ifdef _WIN32
+      return MoveFileExA(source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+      return std::rename(source.c_str(), destination.c_str()) == 0;
+#endif
+    }
+
+    auto remove(const std::string& path) -> bool
+    {
+      struct stat status;
+      if (stat(path.c_str(), &status) != 0) return false;
+      if ((status.st_mode & S_IFMT) != S_IFDIR) return std::remove(path.c_str()) == 0;
+
+      std::vector<std::string> files;
+      std::vector<std::string> directories;
+      if (!list(path, files, directories)) return false;
+      for (const auto& name : files)
+      {
+        if (std::remove((path + "/" + name).c_str()) != 0) return false;
+      }
+      for (const auto& name : directories)
+      {
+        if (!remove(path + "/" + name)) return false;
+      }
+#ifdef _WIN32
+      return _rmdir(path.c_str()) == 0;
+#else
+      return rmdir(path.c_str()) == 0;
+#endif
+    }
+
+    auto list(
+      const std::string& path,
+      std::vector<std::string>& files,
+      std::vector<std::string>& directories
+    ) -> bool
+    {
+#ifdef _WIN32
+      WIN32_FIND_DATAA entry;
+      auto handle = FindFirstFileA((path + "\\*").c_str(), &entry);
+      if (handle == INVALID_HANDLE_VALUE) return false;
+      do
+      {
+        std::string name = entry.cFileName;
+        if (name == "." || name == "..") continue;
+        bool is_link = (entry.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+        bool is_directory = (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        if (!is_directory) files.push_back(name);
+        else if (!is_link) directories.push_back(name);
+      }
+      while (FindNextFileA(handle, &entry));
+      FindClose(handle);
+#else
+      auto directory = opendir(path.c_str());
+      if (directory == nullptr) return false;
+      while (auto entry = readdir(directory))
+      {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+
+        auto entry_path = path + "/" + name;
+        struct stat status;
+        if (lstat(entry_path.c_str(), &status) != 0) continue;
+        if (S_ISDIR(status.st_mode))
+        {
+          directories.push_back(name);
+          continue;
+        }
+        if (S_ISLNK(status.st_mode) && stat(entry_path.c_str(), &status) != 0) continue;
+        if (S_ISREG(status.st_mode)) files.push_back(name);
+      }
+      closedir(directory);
+#endif
+      return true;
+    }
   } // namespace FileInfo
 } // namespace WebDAV
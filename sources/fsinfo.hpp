@@ -25,6 +25,7 @@
 
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace WebDAV
 {
@@ -32,6 +33,42 @@ namespace WebDAV
   {
     auto exists(const std::string& path) -> bool;
     auto size(const std::string& path_file) -> unsigned long long;
+
+    ///
+    /// Creates a directory unless it exists, its parent must exist
+    ///
+    auto create_directory(const std::string& path) -> bool;
+
+    ///
+    /// Gets size and modification time in seconds since the epoch
+    ///
+    auto status(const std::string& path, unsigned long long& size, long long& modified) -> bool;
+
+    ///
+    /// Name of a temporary file next to a file, unique among processes and threads
+    ///
+    auto temporary(const std::string& path) -> std::string;
+
+    ///
+    /// Replaces a file by another one at once, the replaced file is never missing
+    ///
+    auto replace(const std::string& source, const std::string& destination) -> bool;
+
+    ///
+    /// Removes a file or a directory with all its content
+    ///
+    auto remove(const std::string& path) -> bool;
+
+    ///
+    /// Lists names of regular files and subdirectories of a directory.
+    /// Links to files are listed as files, links to directories are skipped
+    /// so a tree with a cycle is walked once.
+    ///
+    auto list(
+      const std::string& path,
+      std::vector<std::string>& files,
+      std::vector<std::string>& directories
+    ) -> bool;
   } // namespace FileInfo
 } // namespace WebDAV
 
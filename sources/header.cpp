@@ -26,7 +26,17 @@
 
 namespace WebDAV
 {
-  Header::Header(const std::initializer_list<std::string>& init_list) noexcept : handle(nullptr)
+  Header::Header(const std::initializer_list<std::string>& init_list) noexcept : handle(nullptr), base(nullptr)
+  {
+    for (auto& item : init_list)
+    {
+      this->append(item);
+    }
+  }
+
+  Header::Header(const Header& base_, const std::initializer_list<std::string>& init_list) noexcept :
+    handle(base_.handle),
+    base(base_.handle)
   {
     for (auto& item : init_list)
     {
@@ -36,13 +46,15 @@ namespace WebDAV
 
   Header::~Header() noexcept
   {
-    curl_slist_free_all(reinterpret_cast<curl_slist*>(this->handle));
+    curl_slist_free_all(reinterpret_cast<curl_slist*>(this->detach()));
   }
 
   Header::Header(Header&& other) noexcept
   {
     handle = other.handle;
+    base = other.base;
     other.handle = nullptr;
+    other.base = nullptr;
   }
 
   auto Header::operator=(Header&& other) noexcept -> Header&
@@ -59,11 +71,83 @@ namespace WebDAV
   {
     using std::swap;
     swap(handle, other.handle);
+    swap(base, other.base);
+  }
+
+  auto Header::detach() noexcept -> void*
+  {
+    if (this->handle == this->base) return nullptr;
+
+    auto own = reinterpret_cast<curl_slist*>(this->handle);
+    if (this->base != nullptr)
+    {
+      auto item = own;
+      while (item->next != this->base) item = item->next;
+      item->next = nullptr;
+    }
+    this->handle = this->base;
+    return own;
+  }
+
+  auto Header::attach(void* own) noexcept -> void
+  {
+    if (own == nullptr) return;
+
+    auto item = reinterpret_cast<curl_slist*>(own);
+    while (item->next != nullptr) item = item->next;
+    item->next = reinterpret_cast<curl_slist*>(this->base);
+    this->handle = own;
   }
 
   void
   Header::append(const std::string& item) noexcept
   {
-    this->handle = curl_slist_append(reinterpret_cast<curl_slist*>(this->handle), item.c_str());
+    // the shared list must not be extended in place
+    auto own = reinterpret_cast<curl_slist*>(this->detach());
+    auto appended = curl_slist_append(own, item.c_str());
+    this->attach(appended != nullptr ? appended : own);
   }
+
+  namespace Headers
+  {
+    auto accept() -> const Header&
+    {
+      static const Header header =
+      {
+        "Accept: */*"
+      };
+      return header;
+    }
+
+    auto keep_alive() -> const Header&
+    {
+      static const Header header =
+      {
+        "Accept: */*",
+        "Connection: Keep-Alive"
+      };
+      return header;
+    }
+
+    auto listing() -> const Header&
+    {
+      static const Header header =
+      {
+        "Accept: */*",
+        "Depth: 1"
+      };
+      return header;
+    }
+
+    auto properties() -> const Header&
+    {
+      static const Header header =
+      {
+        "Accept: */*",
+        "Depth: 0",
+        "Content-Type: text/xml"
+      };
+      return header;
+    }
+  } // namespace Headers
 } // namespace WebDAV
@@ -28,12 +28,18 @@
 
 namespace WebDAV
 {
+  ///
+  /// List of request headers. A list may extend a constant list shared
+  /// between requests: its own items come first and are followed by the items
+  /// of the shared list, which is neither copied nor modified.
+  ///
   class Header final
   {
   public:
     void* handle;
 
     Header(const std::initializer_list<std::string>& init_list) noexcept;
+    Header(const Header& base, const std::initializer_list<std::string>& init_list) noexcept;
     Header(const Header& other) = delete;
     Header(Header&& other) noexcept;
     ~Header() noexcept;
@@ -44,8 +50,23 @@ namespace WebDAV
     void append(const std::string& item) noexcept;
 
   private:
+    void* base;
+
+    auto detach() noexcept -> void*;
+    auto attach(void* own) noexcept -> void;
     auto swap(Header& other) noexcept -> void;
   };
+
+  ///
+  /// Constant header lists shared by all requests
+  ///
+  namespace Headers
+  {
+    auto accept() -> const Header&;
+    auto keep_alive() -> const Header&;
+    auto listing() -> const Header&;
+    auto properties() -> const Header&;
+  } // namespace Headers
 } // namespace WebDAV
 
 #endif
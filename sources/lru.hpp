@@ -0,0 +1,139 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_LRU_HPP
+#define WEBDAV_LRU_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace WebDAV
+{
+  struct Unit
+  {
+    template <typename Value>
+    auto operator()(const Value&) const -> size_t
+    {
+      return 1;
+    }
+  };
+
+  ///
+  /// Size-bounded map which evicts the least recently used items.
+  /// The size of an item is measured by Weight, one per item by default.
+  /// Not thread-safe, callers are expected to guard it.
+  ///
+  template <typename Key, typename Value, typename Weight = Unit, typename Hash = std::hash<Key>>
+  class Lru
+  {
+  public:
+    explicit Lru(size_t capacity_) : capacity(capacity_ == 0 ? 1 : capacity_), weight(0) {}
+
+    auto find(const Key& key) -> Value*
+    {
+      auto it = index.find(key);
+      if (it == index.end()) return nullptr;
+      items.splice(items.begin(), items, it->second);
+      return &it->second->second;
+    }
+
+    auto insert(const Key& key, Value value) -> Value&
+    {
+      auto it = index.find(key);
+      if (it != index.end())
+      {
+        items.splice(items.begin(), items, it->second);
+        weight -= Weight()(it->second->second);
+        weight += Weight()(value);
+        it->second->second = std::move(value);
+      }
+      else
+      {
+        weight += Weight()(value);
+        items.emplace_front(key, std::move(value));
+        index.emplace(key, items.begin());
+      }
+
+      // the most recent item is kept even if it alone exceeds the capacity
+      while (weight > capacity && items.size() > 1)
+      {
+        weight -= Weight()(items.back().second);
+        index.erase(items.back().first);
+        items.pop_back();
+      }
+      return items.front().second;
+    }
+
+    auto erase(const Key& key) -> bool
+    {
+      auto it = index.find(key);
+      if (it == index.end()) return false;
+      weight -= Weight()(it->second->second);
+      items.erase(it->second);
+      index.erase(it);
+      return true;
+    }
+
+    template <typename Predicate>
+    auto erase_if(Predicate predicate) -> void
+    {
+      for (auto it = items.begin(); it != items.end();)
+      {
+        if (predicate(it->first, it->second))
+        {
+          weight -= Weight()(it->second);
+          index.erase(it->first);
+          it = items.erase(it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+
+    auto clear() -> void
+    {
+      index.clear();
+      items.clear();
+      weight = 0;
+    }
+
+    auto size() const -> size_t
+    {
+      return items.size();
+    }
+
+  private:
+    using item_t = std::pair<Key, Value>;
+
+    std::list<item_t> items;
+    std::unordered_map<Key, typename std::list<item_t>::iterator, Hash> index;
+    size_t capacity;
+    size_t weight;
+  };
+} // namespace WebDAV
+
+#endif
@@ -0,0 +1,166 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "percent.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace WebDAV
+{
+  namespace Percent
+  {
+    struct Table
+    {
+      std::array<bool, 256> is_safe;
+      std::array<signed char, 256> hex_value;
+
+      Table() : is_safe()
+      {
+        hex_value.fill(-1);
+        for (int digit = 0; digit < 16; ++digit)
+        {
+          hex_value[static_cast<unsigned char>("0123456789abcdef"[digit])] = static_cast<signed char>(digit);
+          hex_value[static_cast<unsigned char>("0123456789ABCDEF"[digit])] = static_cast<signed char>(digit);
+        }
+
+        const char unreserved[] =
+          "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~/";
+        for (auto symbol : unreserved)
+        {
+          if (symbol != '\0') is_safe[static_cast<unsigned char>(symbol)] = true;
+        }
+      }
+    };
+
+    static const Table table;
+
+    static const char hex[] = "0123456789ABCDEF";
+
+    // the length of the leading run of symbols copied as is
+    static auto safe_prefix(const char* path, size_t length) -> size_t
+    {
+      size_t index = 0;
+#if defined(__SSE2__)
+      // letters are folded to lower case, '-', '.', '/' and digits form one range;
+      // the signed comparisons leave bytes above 0x7F outside of every range
+      const auto fold = _mm_set1_epi8(0x20);
+      const auto before_a = _mm_set1_epi8('a' - 1);
+      const auto after_z = _mm_set1_epi8('z' + 1);
+      const auto before_dash = _mm_set1_epi8('-' - 1);
+      const auto after_nine = _mm_set1_epi8('9' + 1);
+      const auto underscore = _mm_set1_epi8('_');
+      const auto tilde = _mm_set1_epi8('~');
+      for (; index + 16 <= length; index += 16)
+      {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(path + index));
+        auto lower = _mm_or_si128(chunk, fold);
+        auto is_letter = _mm_and_si128(_mm_cmpgt_epi8(lower, before_a), _mm_cmplt_epi8(lower, after_z));
+        auto is_digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, before_dash), _mm_cmplt_epi8(chunk, after_nine));
+        auto is_mark = _mm_or_si128(_mm_cmpeq_epi8(chunk, underscore), _mm_cmpeq_epi8(chunk, tilde));
+        auto is_safe = _mm_or_si128(_mm_or_si128(is_letter, is_digit), is_mark);
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(is_safe));
+        if (mask != 0xFFFF) return index + __builtin_ctz(~mask);
+      }
+#endif
+      while (index < length && table.is_safe[static_cast<unsigned char>(path[index])]) ++index;
+      return index;
+    }
+
+    auto encode(const char* path, size_t length, std::string& output) -> void
+    {
+      auto prefix = safe_prefix(path, length);
+      if (prefix == length)
+      {
+        output.append(path, length);
+        return;
+      }
+
+      // the output grows once for the worst case and is trimmed afterwards
+      auto start = output.length();
+      output.resize(start + prefix + 3 * (length - prefix));
+      auto target = &output[start];
+      std::memcpy(target, path, prefix);
+      target += prefix;
+
+      size_t index = prefix;
+      while (index < length)
+      {
+        auto symbol = static_cast<unsigned char>(path[index++]);
+        *target++ = '%';
+        *target++ = hex[symbol >> 4];
+        *target++ = hex[symbol & 0x0F];
+
+        auto run = safe_prefix(path + index, length - index);
+        std::memcpy(target, path + index, run);
+        target += run;
+        index += run;
+      }
+      output.resize(target - output.data());
+    }
+
+    auto decode(char* data, size_t length, boost::string_view& decoded) -> bool
+    {
+      // the runs between escapes are found with memchr and moved down over the gaps
+      decoded = boost::string_view(data, 0);
+      if (length == 0) return true;
+
+      auto end = data + length;
+      auto source = static_cast<char*>(std::memchr(data, '%', length));
+      if (source == nullptr) source = end;
+      auto target = source;
+      bool has_nul = false;
+      while (source != end)
+      {
+        auto high = end - source > 2 ? table.hex_value[static_cast<unsigned char>(source[1])] : -1;
+        auto low = end - source > 2 ? table.hex_value[static_cast<unsigned char>(source[2])] : -1;
+        if (high == 0 && low == 0)
+        {
+          has_nul = true;
+          *target++ = *source++;
+        }
+        else if (high >= 0 && low >= 0)
+        {
+          *target++ = static_cast<char>((high << 4) | low);
+          source += 3;
+        }
+        else
+        {
+          *target++ = *source++;
+        }
+
+        auto next = static_cast<char*>(std::memchr(source, '%', end - source));
+        if (next == nullptr) next = end;
+        std::memmove(target, source, next - source);
+        target += next - source;
+        source = next;
+      }
+
+      decoded = boost::string_view(data, target - data);
+      return !has_nul;
+    }
+  } // namespace Percent
+} // namespace WebDAV
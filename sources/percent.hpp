@@ -0,0 +1,50 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_PERCENT_HPP
+#define WEBDAV_PERCENT_HPP
+
+#include <boost/utility/string_view.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace WebDAV
+{
+  namespace Percent
+  {
+    ///
+    /// Appends the path percent-encoded as RFC 3986 requires:
+    /// unreserved symbols and separators are copied, other bytes are escaped
+    ///
+    auto encode(const char* path, size_t length, std::string& output) -> void;
+
+    ///
+    /// Decodes the escaped bytes in place, the result is viewed in the same memory.
+    /// Malformed escapes and escaped NUL bytes are kept as is.
+    /// Returns false if an escaped NUL byte is kept
+    ///
+    auto decode(char* data, size_t length, boost::string_view& decoded) -> bool;
+  } // namespace Percent
+} // namespace WebDAV
+
+#endif
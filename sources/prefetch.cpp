@@ -0,0 +1,121 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "prefetch.hpp"
+#include "request.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace WebDAV
+{
+  Prefetcher::Prefetcher(
+    size_t count_,
+    unsigned long long size_limit_,
+    unsigned long long capacity
+  ) :
+    count(count_),
+    // a file larger than the whole cache would be kept over its capacity
+    size_limit(std::min(size_limit_, capacity)),
+    is_stopped(false),
+    blobs(static_cast<size_t>(capacity))
+  {
+    this->worker = std::thread(&Prefetcher::run, this);
+  }
+
+  Prefetcher::~Prefetcher()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->is_stopped = true;
+      this->tasks.clear();
+    }
+    this->condition.notify_all();
+    this->worker.join();
+  }
+
+  auto Prefetcher::schedule(task_t task) -> void
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      // speculative work is dropped rather than queued without bound
+      if (this->tasks.size() >= this->count) this->tasks.pop_front();
+      this->tasks.push_back(std::move(task));
+    }
+    this->condition.notify_one();
+  }
+
+  auto Prefetcher::put(const std::string& key, const std::string& etag, std::string content) -> void
+  {
+    std::lock_guard<std::mutex> lock(this->blobs_mutex);
+    if (content.size() > this->size_limit)
+    {
+      this->blobs.erase(key);
+      return;
+    }
+    this->blobs.insert(key, Blob{ etag, std::move(content) });
+  }
+
+  auto Prefetcher::find(const std::string& key, const std::string& etag, std::string& content) -> bool
+  {
+    std::lock_guard<std::mutex> lock(this->blobs_mutex);
+    auto blob = this->blobs.find(key);
+    if (blob == nullptr) return false;
+    if (etag.empty() || blob->etag != etag) return false;
+    content = blob->content;
+    return true;
+  }
+
+  int Prefetcher::abort(void* prefetcher, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+  {
+    auto self = reinterpret_cast<Prefetcher*>(prefetcher);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    return self->is_stopped || !Request::is_idle() ? 1 : 0;
+  }
+
+  auto Prefetcher::run() -> void
+  {
+    for (;;)
+    {
+      task_t task;
+      {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->condition.wait(lock, [this]()
+        {
+          return this->is_stopped || !this->tasks.empty();
+        });
+        if (this->is_stopped) return;
+
+        // yield to foreground requests before starting a transfer
+        if (!Request::is_idle())
+        {
+          this->condition.wait_for(lock, std::chrono::milliseconds(10));
+          continue;
+        }
+
+        task = std::move(this->tasks.front());
+        this->tasks.pop_front();
+      }
+      task();
+    }
+  }
+} // namespace WebDAV
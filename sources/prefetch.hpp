@@ -0,0 +1,98 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_PREFETCH_HPP
+#define WEBDAV_PREFETCH_HPP
+
+#include "lru.hpp"
+
+#include <curl/curl.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace WebDAV
+{
+  ///
+  /// Speculatively downloads small files in a background thread and keeps
+  /// their content in a size-bounded memory cache. Prefetching waits while
+  /// foreground requests are performed and aborts transfers they overlap.
+  ///
+  class Prefetcher
+  {
+  public:
+    using task_t = std::function<void()>;
+
+    Prefetcher(size_t count, unsigned long long size_limit, unsigned long long capacity);
+    ~Prefetcher();
+
+    Prefetcher(const Prefetcher&) = delete;
+    auto operator=(const Prefetcher&) -> Prefetcher& = delete;
+
+    auto schedule(task_t task) -> void;
+
+    auto put(const std::string& key, const std::string& etag, std::string content) -> void;
+    auto find(const std::string& key, const std::string& etag, std::string& content) -> bool;
+
+    const size_t count;
+    const unsigned long long size_limit;
+
+    ///
+    /// Progress function of background transfers which aborts them
+    /// when foreground requests start or the prefetcher is stopped
+    ///
+    static int abort(void* prefetcher, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+
+  private:
+    struct Blob
+    {
+      std::string etag;
+      std::string content;
+    };
+
+    struct Size
+    {
+      auto operator()(const Blob& blob) const -> size_t
+      {
+        return blob.content.size();
+      }
+    };
+
+    auto run() -> void;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<task_t> tasks;
+    bool is_stopped;
+
+    std::mutex blobs_mutex;
+    Lru<std::string, Blob, Size> blobs;
+
+    std::thread worker;
+  };
+} // namespace WebDAV
+
+#endif
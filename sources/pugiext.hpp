@@ -34,7 +34,7 @@ namespace pugi
 
     void write(const void* data, size_t size) final
     {
-      result += std::string(static_cast<const char*>(data), size);
+      result.append(static_cast<const char*>(data), size);
     }
   };
 
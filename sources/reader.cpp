@@ -0,0 +1,251 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "reader.hpp"
+
+#include "callback.hpp"
+#include "header.hpp"
+#include "request.hpp"
+
+#include <webdav/client.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace WebDAV
+{
+  Reader::Reader(
+    std::shared_ptr<const Config> config_,
+    std::string url_,
+    size_t block_size_,
+    size_t cache_size_
+  ) :
+    config(std::move(config_)),
+    url(std::move(url_)),
+    block_size(block_size_ == 0 ? 1 : block_size_),
+    max_read_ahead(std::max<size_t>(cache_size_ / 2, 1)),
+    cache_size(cache_size_ == 0 ? 1 : cache_size_),
+    file_size(0),
+    is_ranged(true),
+    blocks(cache_size_),
+    next_offset(0),
+    read_ahead(0)
+  {
+  }
+
+  auto Reader::open() -> bool
+  {
+    dict_t headers;
+
+    Request request(*this->config);
+
+    request.set(CURLOPT_URL, this->url.c_str());
+    request.set(CURLOPT_NOBODY, 1L);
+    request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&headers));
+    request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+    bool is_performed = request.perform();
+    if (!is_performed) return false;
+
+    auto content_length = headers.find("content-length");
+    if (content_length == headers.end()) return false;
+    try
+    {
+      this->file_size = boost::lexical_cast<unsigned long long>(content_length->second);
+    }
+    catch (const boost::bad_lexical_cast&)
+    {
+      return false;
+    }
+
+    auto etag = headers.find("etag");
+    if (etag != headers.end()) this->etag = etag->second;
+
+    // without range support the whole file is downloaded once and read from the cache
+    auto accept_ranges = headers.find("accept-ranges");
+    this->is_ranged = accept_ranges == headers.end() || accept_ranges->second != "none";
+    return this->is_ranged || this->is_cached_whole();
+  }
+
+  auto Reader::size() const -> unsigned long long
+  {
+    return this->file_size;
+  }
+
+  auto Reader::is_cached_whole() const -> bool
+  {
+    return (this->file_size + this->block_size - 1) / this->block_size <= this->cache_size;
+  }
+
+  auto Reader::fetch(unsigned long long& first_block, unsigned long long last_block, std::string& data) -> bool
+  {
+    if (!this->is_ranged && !this->is_cached_whole()) return false;
+
+    auto begin = first_block * this->block_size;
+    auto end = std::min(this->file_size, (last_block + 1) * this->block_size) - 1;
+
+    Header header(Headers::accept(), {});
+    // a changed file must not be mixed with the cached blocks
+    if (!this->etag.empty()) header.append("If-Match: " + this->etag);
+
+    auto range = std::to_string(begin) + "-" + std::to_string(end);
+    std::ostringstream stream;
+
+    Request request(*this->config);
+
+    request.set(CURLOPT_CUSTOMREQUEST, "GET");
+    request.set(CURLOPT_URL, this->url.c_str());
+    request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(header.handle));
+    request.set(CURLOPT_RANGE, range.c_str());
+    request.set(CURLOPT_WRITEDATA, reinterpret_cast<size_t>(&stream));
+    request.set(CURLOPT_WRITEFUNCTION, reinterpret_cast<size_t>(Callback::Write::stream));
+#ifdef WDC_VERBOSE
+    request.set(CURLOPT_VERBOSE, 1);
+#endif
+
+    bool is_performed = request.perform();
+    if (!is_performed) return false;
+
+    data = stream.str();
+
+    // a server without range support answers with the whole file,
+    // which is returned whole if it fits into the cache and refused otherwise
+    if (request.status() != 206)
+    {
+      if (data.size() != this->file_size) return false;
+      if (begin == 0 && end + 1 == this->file_size) return true;
+
+      this->is_ranged = false;
+      if (!this->is_cached_whole()) return false;
+      first_block = 0;
+      return true;
+    }
+    data.resize(std::min<size_t>(data.size(), static_cast<size_t>(end - begin + 1)));
+    return true;
+  }
+
+  auto Reader::keep(unsigned long long first_block, const std::string& data) -> void
+  {
+    auto blocks_count = (data.size() + this->block_size - 1) / this->block_size;
+
+    // only the last blocks of a long range fit into the cache
+    auto skipped_count = blocks_count > this->cache_size ? blocks_count - this->cache_size : 0;
+    for (auto index = skipped_count; index < blocks_count; ++index)
+    {
+      auto block_offset = static_cast<size_t>(index * this->block_size);
+      this->blocks.insert(first_block + index, data.substr(block_offset, static_cast<size_t>(this->block_size)));
+    }
+  }
+
+  auto Reader::pread(char* buffer, size_t length, unsigned long long offset) -> long long
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (offset >= this->file_size) return 0;
+    length = static_cast<size_t>(std::min<unsigned long long>(length, this->file_size - offset));
+    if (length == 0) return 0;
+
+    bool is_sequential = offset == this->next_offset;
+    this->read_ahead = is_sequential ? std::min(std::max<unsigned long long>(this->read_ahead * 2, 1), this->max_read_ahead) : 0;
+    this->next_offset = offset + length;
+
+    auto blocks_count = (this->file_size + this->block_size - 1) / this->block_size;
+    auto last_needed_block = (offset + length - 1) / this->block_size;
+
+    size_t read_bytes = 0;
+    while (read_bytes < length)
+    {
+      auto position = offset + read_bytes;
+      auto block = position / this->block_size;
+      auto block_offset = static_cast<size_t>(position - block * this->block_size);
+
+      auto cached_data = this->blocks.find(block);
+      if (cached_data != nullptr)
+      {
+        if (block_offset >= cached_data->size()) break;
+        auto copied_bytes = std::min(cached_data->size() - block_offset, length - read_bytes);
+        memcpy(buffer + read_bytes, cached_data->data() + block_offset, copied_bytes);
+        read_bytes += copied_bytes;
+        continue;
+      }
+
+      // the bytes are copied from the fetched range, which may be longer than the cache;
+      // without range support the whole file is fetched and all its blocks are kept
+      std::string data;
+      auto first_block = this->is_ranged ? block : 0;
+      auto last_block = this->is_ranged ? std::min(std::max(last_needed_block, block + this->read_ahead), blocks_count - 1) : blocks_count - 1;
+      bool is_fetched = this->fetch(first_block, last_block, data);
+      auto data_offset = static_cast<size_t>((block - first_block) * this->block_size) + block_offset;
+      if (!is_fetched || data_offset >= data.size())
+      {
+        return read_bytes == 0 ? -1 : static_cast<long long>(read_bytes);
+      }
+
+      auto copied_bytes = std::min(data.size() - data_offset, length - read_bytes);
+      memcpy(buffer + read_bytes, data.data() + data_offset, copied_bytes);
+      read_bytes += copied_bytes;
+
+      this->keep(first_block, data);
+    }
+
+    return static_cast<long long>(read_bytes);
+  }
+
+  RemoteFile::RemoteFile(std::unique_ptr<Reader> reader_) : reader(std::move(reader_))
+  {
+  }
+
+  RemoteFile::RemoteFile(RemoteFile&& other) noexcept : reader(std::move(other.reader))
+  {
+  }
+
+  RemoteFile::~RemoteFile() = default;
+
+  auto RemoteFile::operator=(RemoteFile&& other) noexcept -> RemoteFile&
+  {
+    this->reader = std::move(other.reader);
+    return *this;
+  }
+
+  auto RemoteFile::is_open() const -> bool
+  {
+    return this->reader != nullptr;
+  }
+
+  auto RemoteFile::size() const -> unsigned long long
+  {
+    if (this->reader == nullptr) return 0;
+    return this->reader->size();
+  }
+
+  auto RemoteFile::pread(char* buffer, size_t length, unsigned long long offset) const -> long long
+  {
+    if (this->reader == nullptr) return -1;
+    return this->reader->pread(buffer, length, offset);
+  }
+} // namespace WebDAV
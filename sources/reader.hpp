@@ -0,0 +1,69 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_READER_HPP
+#define WEBDAV_READER_HPP
+
+#include "config.hpp"
+#include "lru.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace WebDAV
+{
+  ///
+  /// Block cache of a remote file behind WebDAV::RemoteFile
+  ///
+  class Reader
+  {
+  public:
+    Reader(std::shared_ptr<const Config> config, std::string url, size_t block_size, size_t cache_size);
+
+    auto open() -> bool;
+    auto size() const -> unsigned long long;
+    auto pread(char* buffer, size_t length, unsigned long long offset) -> long long;
+
+  private:
+    auto fetch(unsigned long long& first_block, unsigned long long last_block, std::string& data) -> bool;
+    auto is_cached_whole() const -> bool;
+    auto keep(unsigned long long first_block, const std::string& data) -> void;
+
+    const std::shared_ptr<const Config> config;
+    const std::string url;
+    const unsigned long long block_size;
+    const unsigned long long max_read_ahead;
+    const size_t cache_size;
+
+    std::string etag;
+    unsigned long long file_size;
+    bool is_ranged;
+
+    std::mutex mutex;
+    Lru<unsigned long long, std::string> blocks;
+    unsigned long long next_offset;
+    unsigned long long read_ahead;
+  };
+} // namespace WebDAV
+
+#endif
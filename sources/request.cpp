@@ -21,38 +21,31 @@
 ############################################################################*/
 
 #include "request.hpp"
-#include "fsinfo.hpp"
+#include "share.hpp"
+
+#include <atomic>
 
 namespace WebDAV
 {
-  auto inline get(const dict_t& options, const std::string&& name) -> std::string
+  static std::atomic<unsigned> foreground_requests(0);
+
+  Request::Request(const Config& config) : is_background(false), is_borrowed(false)
   {
-    auto it = options.find(name);
-    if (it == options.end())
-    {
-      return std::string{""};
-    }
-    else
-    {
-      return it->second;
-    }
+    this->handle = curl_easy_init();
+    this->configure(config);
   }
 
-  Request::Request(dict_t&& options_) : options(options_)
+  Request::Request(const Config& config, const Connection& connection) : is_background(false), is_borrowed(true)
   {
-    auto webdav_hostname = get(options, "webdav_hostname");
-    auto webdav_username = get(options, "webdav_username");
-    auto webdav_password = get(options, "webdav_password");
-
-    auto proxy_hostname = get(options, "proxy_hostname");
-    auto proxy_username = get(options, "proxy_username");
-    auto proxy_password = get(options, "proxy_password");
-
-    auto cert_path = get(options, "cert_path");
-    auto key_path = get(options, "key_path");
-
-    this->handle = curl_easy_init();
+    // the reset keeps the open connections of the handle
+    this->handle = connection.handle;
+    if (this->handle != nullptr) curl_easy_reset(this->handle);
+    this->configure(config);
+    if (connection.share != nullptr) this->share(*connection.share);
+  }
 
+  auto Request::configure(const Config& config) -> void
+  {
     this->set(CURLOPT_SSL_VERIFYHOST, 0);
     this->set(CURLOPT_SSL_VERIFYPEER, 0);
 
@@ -61,40 +54,46 @@ namespace WebDAV
 #else
     this->set(CURLOPT_VERBOSE, 0);
 #endif
-    if (this->cert_required())
+    // a certificate is loaded once its files can be read, at the construction or on a reload
+    auto certificate = config.certificate();
+    if (certificate != nullptr)
     {
       this->set(CURLOPT_SSLCERTTYPE, "PEM");
       this->set(CURLOPT_SSLKEYTYPE, "PEM");
-      this->set(CURLOPT_SSLCERT, const_cast<char*>(cert_path.c_str()));
-      this->set(CURLOPT_SSLKEY, const_cast<char*>(key_path.c_str()));
+#if LIBCURL_VERSION_NUM >= 0x074700
+      // the certificate is passed from memory, curl does not read the files
+      curl_blob cert_blob = { const_cast<char*>(certificate->cert.data()), certificate->cert.size(), CURL_BLOB_COPY };
+      curl_blob key_blob = { const_cast<char*>(certificate->key.data()), certificate->key.size(), CURL_BLOB_COPY };
+      this->set(CURLOPT_SSLCERT_BLOB, &cert_blob);
+      this->set(CURLOPT_SSLKEY_BLOB, &key_blob);
+#else
+      this->set(CURLOPT_SSLCERT, config.cert_path.c_str());
+      this->set(CURLOPT_SSLKEY, config.key_path.c_str());
+#endif
     }
 
-    this->set(CURLOPT_URL, const_cast<char*>(webdav_hostname.c_str()));
+    this->set(CURLOPT_URL, config.hostname.c_str());
     this->set(CURLOPT_HTTPAUTH, static_cast<int>(CURLAUTH_BASIC));
-    auto token = webdav_username + ":" + webdav_password;
-    this->set(CURLOPT_USERPWD, const_cast<char*>(token.c_str()));
+    this->set(CURLOPT_USERPWD, config.credentials.c_str());
 
-    if (!this->proxy_enabled()) return;
+    if (!config.is_proxy_enabled) return;
 
-    this->set(CURLOPT_PROXY, const_cast<char*>(proxy_hostname.c_str()));
+    this->set(CURLOPT_PROXY, config.proxy_hostname.c_str());
     this->set(CURLOPT_PROXYAUTH, static_cast<int>(CURLAUTH_BASIC));
 
-    if (proxy_username.empty()) return;
-
-    if (proxy_password.empty())
+    if (!config.proxy_username.empty())
     {
-      this->set(CURLOPT_PROXYUSERNAME, const_cast<char*>(proxy_username.c_str()));
+      this->set(CURLOPT_PROXYUSERNAME, config.proxy_username.c_str());
     }
-    else
+    else if (!config.proxy_credentials.empty())
     {
-      token = proxy_username + ":" + proxy_password;
-      this->set(CURLOPT_PROXYUSERPWD, const_cast<char*>(token.c_str()));
+      this->set(CURLOPT_PROXYUSERPWD, config.proxy_credentials.c_str());
     }
   }
 
   Request::~Request() noexcept
   {
-    if (this->handle != nullptr) curl_easy_cleanup(this->handle);
+    if (this->handle != nullptr && !this->is_borrowed) curl_easy_cleanup(this->handle);
   }
 
 
@@ -102,11 +101,19 @@ namespace WebDAV
   {
     using std::swap;
     swap(handle, other.handle);
+    swap(is_background, other.is_background);
+    swap(is_borrowed, other.is_borrowed);
   }
 
   Request::Request(Request&& other) noexcept : handle
   {
     other.handle
+  }, is_background
+  {
+    other.is_background
+  }, is_borrowed
+  {
+    other.is_borrowed
   }
   {
     other.handle = nullptr;
@@ -124,7 +131,9 @@ namespace WebDAV
   bool Request::perform() const noexcept
   {
     if (this->handle == nullptr) return false;
+    if (!this->is_background) ++foreground_requests;
     auto is_performed = check_code(curl_easy_perform(this->handle));
+    if (!this->is_background) --foreground_requests;
     if (!is_performed) return false;
     long http_code = 0;
     curl_easy_getinfo(this->handle, CURLINFO_RESPONSE_CODE, &http_code);
@@ -132,27 +141,26 @@ namespace WebDAV
     return true;
   }
 
-  bool Request::proxy_enabled() const noexcept
+  auto Request::share(const Share& share) const noexcept -> bool
   {
-    auto proxy_hostname = get(options, "proxy_hostname");
-    auto proxy_username = get(options, "proxy_username");
-    auto proxy_password = get(options, "proxy_password");
-    bool proxy_hostname_presented = !proxy_hostname.empty();
-    if (!proxy_hostname_presented) return false;
-    bool proxy_username_presented = !proxy_username.empty();
-    bool proxy_password_presented = !proxy_password.empty();
-    if (proxy_password_presented && !proxy_username_presented) return false;
-    return true;
+    return this->set(CURLOPT_SHARE, share.handle);
   }
 
-  bool Request::cert_required() const noexcept
+  auto Request::make_background() noexcept -> void
   {
-    const auto cert_path = get(options, "cert_path");
-    const auto key_path = get(options, "key_path");
-    if (cert_path.empty()) return false;
-    bool cert_is_existed = FileInfo::exists(cert_path);
-    if (!cert_is_existed) return false;
-    if (key_path.empty()) return false;
-    return FileInfo::exists(key_path);
+    this->is_background = true;
+  }
+
+  auto Request::is_idle() noexcept -> bool
+  {
+    return foreground_requests == 0;
+  }
+
+  auto Request::status() const noexcept -> long
+  {
+    long http_code = 0;
+    if (this->handle == nullptr) return http_code;
+    curl_easy_getinfo(this->handle, CURLINFO_RESPONSE_CODE, &http_code);
+    return http_code;
   }
 } // namespace WebDAV
@@ -23,23 +23,29 @@
 #ifndef WEBDAV_REQUEST_HPP
 #define WEBDAV_REQUEST_HPP
 
+#include "config.hpp"
+
 #include <curl/curl.h>
-#include <map>
-#include <string>
 
 namespace WebDAV
 {
+  class Connection;
+  class Share;
+
   bool inline check_code(CURLcode code)
   {
     return code == CURLE_OK;
   }
 
-  using dict_t = std::map<std::string, std::string>;
-
   class Request
   {
   public:
-    explicit Request(dict_t&& options_);
+    explicit Request(const Config& config);
+
+    ///
+    /// A request on the handle of the connection, which keeps the handle
+    ///
+    Request(const Config& config, const Connection& connection);
     Request(const Request& other) = delete;
     Request(Request&& other) noexcept;
     ~Request() noexcept;
@@ -54,13 +60,23 @@ namespace WebDAV
       return check_code(curl_easy_setopt(this->handle, option, value));
     }
 
+    auto share(const Share& share) const noexcept -> bool;
+
     bool perform() const noexcept;
+    auto status() const noexcept -> long;
     void* handle;
 
+    ///
+    /// Background requests are not counted as foreground activity,
+    /// see Request::is_idle
+    ///
+    auto make_background() noexcept -> void;
+    static auto is_idle() noexcept -> bool;
+
   private:
-    const dict_t options;
-    bool proxy_enabled() const noexcept;
-    bool cert_required() const noexcept;
+    bool is_background;
+    bool is_borrowed;
+    auto configure(const Config& config) -> void;
     auto swap(Request& other) noexcept -> void;
   };
 } // namespace WebDAV
@@ -0,0 +1,64 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "scratch.hpp"
+
+#include <vector>
+
+namespace WebDAV
+{
+  enum
+  {
+    // larger buffers are released, not to pin the memory of a rare huge response
+    max_retained_capacity = 1024 * 1024,
+    max_retained_buffers = 4
+  };
+
+  static thread_local std::vector<std::unique_ptr<Data>> pool;
+
+  Scratch::Scratch()
+  {
+    // the pool never reallocates while a buffer is returned
+    pool.reserve(max_retained_buffers);
+    if (pool.empty())
+    {
+      this->buffer.reset(new Data{ nullptr, 0, 0, 0 });
+      return;
+    }
+    this->buffer = std::move(pool.back());
+    pool.pop_back();
+  }
+
+  Scratch::~Scratch()
+  {
+    bool is_retained = this->buffer->capacity <= max_retained_capacity && pool.size() < max_retained_buffers;
+    if (!is_retained) return;
+    this->buffer->position = 0;
+    this->buffer->size = 0;
+    pool.push_back(std::move(this->buffer));
+  }
+
+  auto Scratch::data() -> Data&
+  {
+    return *this->buffer;
+  }
+} // namespace WebDAV
@@ -0,0 +1,53 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_SCRATCH_HPP
+#define WEBDAV_SCRATCH_HPP
+
+#include "callback.hpp"
+
+#include <memory>
+
+namespace WebDAV
+{
+  ///
+  /// Response buffer borrowed from a pool of the current thread.
+  /// The buffer keeps its capacity between requests, so a steady stream
+  /// of similar requests does not allocate for their responses.
+  ///
+  class Scratch
+  {
+  public:
+    Scratch();
+    ~Scratch();
+
+    Scratch(const Scratch& other) = delete;
+    auto operator=(const Scratch& other) -> Scratch& = delete;
+
+    auto data() -> Data&;
+
+  private:
+    std::unique_ptr<Data> buffer;
+  };
+} // namespace WebDAV
+
+#endif
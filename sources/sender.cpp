@@ -0,0 +1,183 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "sender.hpp"
+
+#include "callback.hpp"
+
+#include <webdav/client.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace WebDAV
+{
+  Sender::Sender(Request&& request_, Header&& header_, size_t buffer_size, completion_t completion_) :
+    request(std::move(request_)),
+    header(std::move(header_)),
+    multi_handle(curl_multi_init()),
+    completion(std::move(completion_)),
+    buffer(std::max<size_t>(buffer_size, 1)),
+    position(0),
+    sent_size(0),
+    is_paused(false),
+    is_running(true),
+    is_finished(false),
+    is_failed(false),
+    is_completed(false)
+  {
+    this->request.set(CURLOPT_UPLOAD, 1L);
+    this->request.set(CURLOPT_HTTPHEADER, reinterpret_cast<curl_slist*>(this->header.handle));
+    this->request.set(CURLOPT_HEADERDATA, reinterpret_cast<size_t>(&this->headers));
+    this->request.set(CURLOPT_HEADERFUNCTION, reinterpret_cast<size_t>(Callback::Parse::headers));
+    this->request.set(CURLOPT_READDATA, reinterpret_cast<size_t>(this));
+    this->request.set(CURLOPT_READFUNCTION, reinterpret_cast<size_t>(Sender::read));
+    curl_multi_add_handle(this->multi_handle, this->request.handle);
+    this->setp(this->buffer.data(), this->buffer.data() + this->buffer.size());
+  }
+
+  Sender::~Sender()
+  {
+    // an unclosed upload is aborted rather than committed truncated
+    curl_multi_remove_handle(this->multi_handle, this->request.handle);
+    curl_multi_cleanup(this->multi_handle);
+    this->complete(false);
+  }
+
+  auto Sender::read(char* ptr, size_t item_size, size_t item_count, void* sender) -> size_t
+  {
+    auto self = reinterpret_cast<Sender*>(sender);
+    auto size = item_size * item_count;
+    auto length = static_cast<size_t>(self->pptr() - self->pbase());
+
+    if (self->position == length)
+    {
+      if (self->is_finished) return 0;
+      self->is_paused = true;
+      return CURL_READFUNC_PAUSE;
+    }
+
+    auto copied_bytes = std::min(size, length - self->position);
+    memcpy(ptr, self->pbase() + self->position, copied_bytes);
+    self->position += copied_bytes;
+    self->sent_size += copied_bytes;
+    return copied_bytes;
+  }
+
+  auto Sender::drain(bool is_final) -> bool
+  {
+    if (this->is_failed) return false;
+
+    this->is_finished = is_final;
+    this->position = 0;
+    auto length = static_cast<size_t>(this->pptr() - this->pbase());
+
+    if (this->is_paused)
+    {
+      this->is_paused = false;
+      curl_easy_pause(this->request.handle, CURLPAUSE_CONT);
+    }
+
+    // the buffer is reused only after the request has taken all of it
+    while (this->is_running && (this->position < length || this->is_finished))
+    {
+      int running_handles = 0;
+      curl_multi_perform(this->multi_handle, &running_handles);
+      this->is_running = running_handles != 0;
+      if (!this->is_running) break;
+      if (this->position == length && !this->is_finished) break;
+      curl_multi_wait(this->multi_handle, nullptr, 0, 1000, nullptr);
+    }
+
+    if (!this->is_running)
+    {
+      int messages_count = 0;
+      while (auto message = curl_multi_info_read(this->multi_handle, &messages_count))
+      {
+        if (message->msg == CURLMSG_DONE && message->data.result != CURLE_OK) this->is_failed = true;
+      }
+      auto status = this->request.status();
+      if (status < 200 || status > 299) this->is_failed = true;
+      // the request is over before all the data are sent
+      if (this->position < length || !this->is_finished) this->is_failed = true;
+      this->complete(!this->is_failed);
+    }
+
+    this->setp(this->buffer.data(), this->buffer.data() + this->buffer.size());
+    return !this->is_failed;
+  }
+
+  auto Sender::complete(bool is_performed) -> void
+  {
+    if (this->is_completed) return;
+    this->is_completed = true;
+    if (this->completion != nullptr) this->completion(is_performed, this->headers, this->sent_size);
+  }
+
+  auto Sender::overflow(int_type symbol) -> int_type
+  {
+    if (!this->drain(false)) return traits_type::eof();
+    if (traits_type::eq_int_type(symbol, traits_type::eof())) return traits_type::not_eof(symbol);
+    *this->pptr() = traits_type::to_char_type(symbol);
+    this->pbump(1);
+    return symbol;
+  }
+
+  auto Sender::sync() -> int
+  {
+    return this->drain(false) ? 0 : -1;
+  }
+
+  auto Sender::close() -> bool
+  {
+    if (this->is_completed) return !this->is_failed;
+    return this->drain(true);
+  }
+
+  RemoteWriter::RemoteWriter(std::unique_ptr<Sender> sender_) : std::ostream(nullptr), sender(std::move(sender_))
+  {
+    if (this->sender != nullptr) this->rdbuf(this->sender.get());
+  }
+
+  RemoteWriter::RemoteWriter(RemoteWriter&& other) noexcept : std::ostream(std::move(other)), sender(std::move(other.sender))
+  {
+    this->set_rdbuf(this->sender.get());
+  }
+
+  RemoteWriter::~RemoteWriter() = default;
+
+  auto RemoteWriter::operator=(RemoteWriter&& other) noexcept -> RemoteWriter&
+  {
+    std::ostream::operator=(std::move(other));
+    this->sender = std::move(other.sender);
+    this->set_rdbuf(this->sender.get());
+    return *this;
+  }
+
+  auto RemoteWriter::close() -> bool
+  {
+    if (this->sender == nullptr) return false;
+    bool is_closed = this->sender->close();
+    if (!is_closed) this->setstate(std::ios::badbit);
+    return is_closed;
+  }
+} // namespace WebDAV
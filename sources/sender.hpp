@@ -0,0 +1,80 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_SENDER_HPP
+#define WEBDAV_SENDER_HPP
+
+#include "header.hpp"
+#include "request.hpp"
+
+#include <functional>
+#include <streambuf>
+#include <vector>
+
+namespace WebDAV
+{
+  using completion_t = std::function<void(bool is_performed, const dict_t& headers, unsigned long long size)>;
+
+  ///
+  /// Stream buffer behind WebDAV::RemoteWriter.
+  /// Written data are pushed into a PUT request whenever the buffer is full,
+  /// the writer waits until the request has taken the whole buffer.
+  /// The request is paused while the buffer is empty.
+  ///
+  class Sender : public std::streambuf
+  {
+  public:
+    Sender(Request&& request, Header&& header, size_t buffer_size, completion_t completion);
+    ~Sender();
+
+    Sender(const Sender& other) = delete;
+    auto operator=(const Sender& other) -> Sender& = delete;
+
+    auto close() -> bool;
+
+  protected:
+    auto overflow(int_type symbol) -> int_type override;
+    auto sync() -> int override;
+
+  private:
+    static auto read(char* ptr, size_t item_size, size_t item_count, void* sender) -> size_t;
+
+    auto drain(bool is_final) -> bool;
+    auto complete(bool is_performed) -> void;
+
+    Request request;
+    Header header;
+    void* multi_handle;
+    completion_t completion;
+    dict_t headers;
+    std::vector<char> buffer;
+    size_t position;
+    unsigned long long sent_size;
+    bool is_paused;
+    bool is_running;
+    bool is_finished;
+    bool is_failed;
+    bool is_completed;
+  };
+} // namespace WebDAV
+
+#endif
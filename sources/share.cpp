@@ -0,0 +1,61 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "share.hpp"
+
+namespace WebDAV
+{
+  Share::Share()
+  {
+    auto share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, Share::lock);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, Share::unlock);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    this->handle = share;
+  }
+
+  Share::~Share()
+  {
+    if (this->handle != nullptr) curl_share_cleanup(this->handle);
+  }
+
+  Connection::Connection(const Share* share_) : handle(curl_easy_init()), share(share_)
+  {
+  }
+
+  Connection::~Connection()
+  {
+    if (this->handle != nullptr) curl_easy_cleanup(this->handle);
+  }
+
+  auto Share::lock(CURL*, curl_lock_data data, curl_lock_access, void* share) -> void
+  {
+    static_cast<Share*>(share)->mutexes[data].lock();
+  }
+
+  auto Share::unlock(CURL*, curl_lock_data data, void* share) -> void
+  {
+    static_cast<Share*>(share)->mutexes[data].unlock();
+  }
+} // namespace WebDAV
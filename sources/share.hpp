@@ -0,0 +1,75 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_SHARE_HPP
+#define WEBDAV_SHARE_HPP
+
+#include <curl/curl.h>
+
+#include <array>
+#include <mutex>
+
+namespace WebDAV
+{
+  ///
+  /// DNS lookups and TLS sessions shared by requests of many threads,
+  /// so parallel transfers do not resolve and handshake anew for every file.
+  /// Connections are not shared, curl does not allow that for concurrent
+  /// requests; see Connection. It must outlive the requests which use it.
+  ///
+  class Share
+  {
+  public:
+    Share();
+    ~Share();
+
+    Share(const Share& other) = delete;
+    auto operator=(const Share& other) -> Share& = delete;
+
+    void* handle;
+
+  private:
+    static auto lock(CURL* request, curl_lock_data data, curl_lock_access access, void* share) -> void;
+    static auto unlock(CURL* request, curl_lock_data data, void* share) -> void;
+
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> mutexes;
+  };
+
+  ///
+  /// A handle which one thread keeps for its requests one after another,
+  /// so they reuse its connections. It must outlive the requests which use it.
+  ///
+  class Connection
+  {
+  public:
+    explicit Connection(const Share* share = nullptr);
+    ~Connection();
+
+    Connection(const Connection& other) = delete;
+    auto operator=(const Connection& other) -> Connection& = delete;
+
+    void* handle;
+    const Share* share;
+  };
+} // namespace WebDAV
+
+#endif
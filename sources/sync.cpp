@@ -0,0 +1,581 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "sync.hpp"
+#include "fsinfo.hpp"
+#include "percent.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <set>
+#include <utility>
+
+namespace WebDAV
+{
+  namespace Sync
+  {
+    const char* const state_file = ".webdav-sync";
+    const char* const listing_file = ".webdav-sync-listing";
+
+    auto Less::operator()(const std::string& lhs, const std::string& rhs) const -> bool
+    {
+      auto length = std::min(lhs.length(), rhs.length());
+      for (size_t index = 0; index < length; ++index)
+      {
+        auto left = static_cast<unsigned char>(lhs[index]);
+        auto right = static_cast<unsigned char>(rhs[index]);
+        if (left == right) continue;
+        if (left == '/') return true;
+        if (right == '/') return false;
+        return left < right;
+      }
+      return lhs.length() < rhs.length();
+    }
+
+    auto is_below(const std::string& path, const std::string& directory) -> bool
+    {
+      return path.length() > directory.length() &&
+             path[directory.length()] == '/' &&
+             path.compare(0, directory.length(), directory) == 0;
+    }
+
+    auto inline find(const states_t& states, const std::string& path) -> const State*
+    {
+      auto it = states.find(path);
+      return it == states.end() ? nullptr : &it->second;
+    }
+
+    auto inline is_changed_locally(const State& local, const State& base) -> bool
+    {
+      return local.is_directory != base.is_directory || local.size != base.size || local.modified != base.modified;
+    }
+
+    auto inline is_changed_remotely(const State& remote, const State& base) -> bool
+    {
+      return remote.is_directory != base.is_directory || remote.etag != base.etag;
+    }
+
+    using is_changed_t = bool(*)(const State& state, const State& base);
+
+    auto inline is_untouched(
+      const states_t& states,
+      const states_t& base,
+      const std::string& directory,
+      is_changed_t is_changed
+    ) -> bool
+    {
+      // the items of a directory follow it
+      for (auto it = states.upper_bound(directory); it != states.end() && is_below(it->first, directory); ++it)
+      {
+        auto state = find(base, it->first);
+        if (state == nullptr) return false;
+        if (!it->second.is_directory && is_changed(it->second, *state)) return false;
+      }
+      return true;
+    }
+
+    auto inline make_action(
+      SyncAction::Kind kind,
+      const std::string& path,
+      bool is_directory,
+      unsigned long long size = 0
+    ) -> SyncAction
+    {
+      return SyncAction{ kind, path, std::string{}, size, is_directory, false };
+    }
+
+    // true if the items of the directory are settled with it
+    auto inline plan_directory(
+      const std::string& path,
+      const State* local,
+      const State* remote,
+      const State* base,
+      const states_t& local_states,
+      const states_t& remote_states,
+      const states_t& base_states,
+      actions_t& actions
+    ) -> bool
+    {
+      if (local != nullptr && remote != nullptr)
+      {
+        if (local->is_directory == remote->is_directory) return false;
+        actions.push_back(make_action(SyncAction::conflict, path, true));
+        return true;
+      }
+
+      if (local != nullptr)
+      {
+        if (base == nullptr)
+        {
+          actions.push_back(make_action(SyncAction::create_remote_directory, path, true));
+          return false;
+        }
+        // removed remotely, the local copy goes only if nothing has changed in it since
+        bool is_removed = is_untouched(local_states, base_states, path, is_changed_locally);
+        actions.push_back(make_action(is_removed ? SyncAction::remove_local : SyncAction::conflict, path, true));
+        return true;
+      }
+
+      if (base == nullptr)
+      {
+        actions.push_back(make_action(SyncAction::create_local_directory, path, true));
+        return false;
+      }
+      bool is_removed = is_untouched(remote_states, base_states, path, is_changed_remotely);
+      actions.push_back(make_action(is_removed ? SyncAction::remove_remote : SyncAction::conflict, path, true));
+      return true;
+    }
+
+    auto inline plan_file(
+      const std::string& path,
+      const State* local,
+      const State* remote,
+      const State* base,
+      actions_t& actions
+    ) -> void
+    {
+      if (local != nullptr && remote != nullptr)
+      {
+        // without a record only files of the same content are synchronized
+        if (base == nullptr)
+        {
+          if (local->size != remote->size) actions.push_back(make_action(SyncAction::conflict, path, false));
+          else actions.push_back(make_action(SyncAction::compare, path, false, remote->size));
+          return;
+        }
+
+        bool is_local_changed = is_changed_locally(*local, *base);
+        bool is_remote_changed = is_changed_remotely(*remote, *base);
+        if (is_local_changed && is_remote_changed)
+        {
+          actions.push_back(make_action(SyncAction::conflict, path, false));
+        }
+        else if (is_local_changed)
+        {
+          actions.push_back(make_action(SyncAction::upload, path, false, local->size));
+        }
+        else if (is_remote_changed)
+        {
+          actions.push_back(make_action(SyncAction::download, path, false, remote->size));
+        }
+        return;
+      }
+
+      if (local != nullptr)
+      {
+        if (base == nullptr) actions.push_back(make_action(SyncAction::upload, path, false, local->size));
+        else if (is_changed_locally(*local, *base)) actions.push_back(make_action(SyncAction::conflict, path, false));
+        else actions.push_back(make_action(SyncAction::remove_local, path, false));
+        return;
+      }
+
+      if (remote != nullptr)
+      {
+        if (base == nullptr) actions.push_back(make_action(SyncAction::download, path, false, remote->size));
+        else if (is_changed_remotely(*remote, *base)) actions.push_back(make_action(SyncAction::conflict, path, false));
+        else actions.push_back(make_action(SyncAction::remove_remote, path, false));
+      }
+    }
+
+    auto inline plan_moves(const states_t& local, const states_t& remote, const states_t& base, actions_t& actions) -> void
+    {
+      // a moved file keeps its size and modification time locally, its ETag remotely;
+      // only files which are new on a side are the destinations
+      std::multimap<std::pair<unsigned long long, long long>, size_t> uploads;
+      std::multimap<std::string, size_t> downloads;
+      for (size_t index = 0; index < actions.size(); ++index)
+      {
+        const auto& action = actions[index];
+        if (base.count(action.path) != 0) continue;
+        if (action.kind == SyncAction::upload)
+        {
+          const auto& state = local.at(action.path);
+          uploads.emplace(std::make_pair(state.size, state.modified), index);
+        }
+        if (action.kind == SyncAction::download)
+        {
+          const auto& state = remote.at(action.path);
+          if (!state.etag.empty()) downloads.emplace(state.etag, index);
+        }
+      }
+      if (uploads.empty() && downloads.empty()) return;
+
+      std::vector<bool> is_moved(actions.size(), false);
+      for (auto& action : actions)
+      {
+        if (action.is_directory) continue;
+
+        if (action.kind == SyncAction::remove_remote)
+        {
+          const auto& state = base.at(action.path);
+          auto it = uploads.find(std::make_pair(state.size, state.modified));
+          if (it == uploads.end()) continue;
+          action.kind = SyncAction::move_remote;
+          action.destination = actions[it->second].path;
+          is_moved[it->second] = true;
+          uploads.erase(it);
+        }
+        else if (action.kind == SyncAction::remove_local)
+        {
+          const auto& state = base.at(action.path);
+          auto it = state.etag.empty() ? downloads.end() : downloads.find(state.etag);
+          if (it == downloads.end()) continue;
+          action.kind = SyncAction::move_local;
+          action.destination = actions[it->second].path;
+          is_moved[it->second] = true;
+          downloads.erase(it);
+        }
+      }
+
+      size_t count = 0;
+      for (size_t index = 0; index < actions.size(); ++index)
+      {
+        if (is_moved[index]) continue;
+        if (count != index) actions[count] = std::move(actions[index]);
+        ++count;
+      }
+      actions.resize(count);
+    }
+
+    auto plan(const states_t& local, const states_t& remote, const states_t& base) -> actions_t
+    {
+      std::set<std::string, Less> paths;
+      for (const auto& item : local) paths.insert(item.first);
+      for (const auto& item : remote) paths.insert(item.first);
+      for (const auto& item : base) paths.insert(item.first);
+
+      actions_t actions;
+      std::string settled;
+      for (const auto& path : paths)
+      {
+        if (!settled.empty() && is_below(path, settled)) continue;
+        settled.clear();
+
+        auto local_state = find(local, path);
+        auto remote_state = find(remote, path);
+        auto base_state = find(base, path);
+
+        bool is_directory = (local_state != nullptr && local_state->is_directory) ||
+                            (remote_state != nullptr && remote_state->is_directory);
+        if (is_directory)
+        {
+          if (plan_directory(path, local_state, remote_state, base_state, local, remote, base, actions)) settled = path;
+          continue;
+        }
+        plan_file(path, local_state, remote_state, base_state, actions);
+      }
+
+      plan_moves(local, remote, base, actions);
+      return actions;
+    }
+
+    auto estimate(SyncPlan& plan) -> void
+    {
+      plan.upload_size = 0;
+      plan.download_size = 0;
+      plan.requests = 0;
+      plan.conflicts = 0;
+      for (const auto& action : plan.actions)
+      {
+        switch (action.kind)
+        {
+          case SyncAction::upload:
+            plan.upload_size += action.size;
+            ++plan.requests;
+            break;
+          case SyncAction::download:
+          case SyncAction::compare:
+            plan.download_size += action.size;
+            ++plan.requests;
+            break;
+          case SyncAction::create_remote_directory:
+          case SyncAction::remove_remote:
+            ++plan.requests;
+            break;
+          case SyncAction::move_remote:
+            // the ETag of the destination is asked for after the move
+            plan.requests += 2;
+            break;
+          case SyncAction::conflict:
+            ++plan.conflicts;
+            break;
+          default:
+            break;
+        }
+      }
+    }
+
+    auto update(const Session& session) -> states_t
+    {
+      // what has not been touched keeps its record, e.g. a conflict
+      auto states = session.base;
+
+      std::set<std::string, Less> touched;
+      for (const auto& action : *session.actions)
+      {
+        touched.insert(action.path);
+        if (!action.destination.empty()) touched.insert(action.destination);
+      }
+
+      for (const auto& item : session.local)
+      {
+        auto remote = find(session.remote, item.first);
+        if (remote == nullptr || touched.count(item.first) != 0) continue;
+        if (remote->is_directory != item.second.is_directory) continue;
+        states[item.first] = State{ item.second.is_directory, remote->etag, item.second.size, item.second.modified };
+      }
+      for (const auto& item : session.base)
+      {
+        if (session.local.count(item.first) == 0 && session.remote.count(item.first) == 0) states.erase(item.first);
+      }
+
+      const auto& actions = *session.actions;
+      for (size_t index = 0; index < actions.size(); ++index)
+      {
+        const auto& action = actions[index];
+        if (!action.is_done) continue;
+
+        switch (action.kind)
+        {
+          case SyncAction::upload:
+          case SyncAction::download:
+          case SyncAction::create_remote_directory:
+          case SyncAction::create_local_directory:
+          case SyncAction::compare:
+            states[action.path] = session.results[index];
+            break;
+          case SyncAction::move_remote:
+          case SyncAction::move_local:
+            states.erase(action.path);
+            states[action.destination] = session.results[index];
+            break;
+          case SyncAction::remove_remote:
+          case SyncAction::remove_local:
+          {
+            auto it = states.find(action.path);
+            while (it != states.end() && (it->first == action.path || is_below(it->first, action.path)))
+            {
+              it = states.erase(it);
+            }
+            break;
+          }
+          case SyncAction::conflict:
+            break;
+        }
+      }
+      return states;
+    }
+
+    auto load(
+      const std::string& local_directory,
+      const char* name,
+      const std::string& origin,
+      states_t& states,
+      std::string& token
+    ) -> void
+    {
+      states.clear();
+      token.clear();
+      std::ifstream stream(local_directory + "/" + name);
+      std::string line;
+      if (!std::getline(stream, line) || line != origin) return;
+      if (!std::getline(stream, token)) return;
+
+      // a line is: quoted path, type, ETag, size, modification time
+      while (std::getline(stream, line))
+      {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        for (;;)
+        {
+          auto end = line.find('\t', start);
+          fields.push_back(line.substr(start, end == std::string::npos ? std::string::npos : end - start));
+          if (end == std::string::npos) break;
+          start = end + 1;
+        }
+        if (fields.size() != 5 || fields[0].empty()) continue;
+
+        boost::string_view path;
+        Percent::decode(&fields[0][0], fields[0].length(), path);
+        states[std::string(path.data(), path.length())] = State
+        {
+          fields[1] == "d",
+          fields[2],
+          std::strtoull(fields[3].c_str(), nullptr, 10),
+          std::strtoll(fields[4].c_str(), nullptr, 10)
+        };
+      }
+    }
+
+    auto save(
+      const std::string& local_directory,
+      const char* name,
+      const std::string& origin,
+      const states_t& states,
+      const std::string& token
+    ) -> bool
+    {
+      // the states are replaced at once, an interrupted save keeps the previous ones
+      auto file = local_directory + "/" + name;
+      auto partial_file = file + ".part";
+      {
+        std::ofstream stream(partial_file, std::ios::trunc);
+        stream << origin << '\n' << token << '\n';
+        std::string path;
+        for (const auto& item : states)
+        {
+          path.clear();
+          Percent::encode(item.first.data(), item.first.length(), path);
+          stream << path << '\t' << (item.second.is_directory ? "d" : "f") << '\t' << item.second.etag << '\t'
+                 << item.second.size << '\t' << item.second.modified << '\n';
+        }
+        if (!stream) return false;
+      }
+      return FileInfo::replace(partial_file, file);
+    }
+
+    auto inline ends_with(const std::string& name, const char* suffix) -> bool
+    {
+      auto length = std::strlen(suffix);
+      return name.length() > length && name.compare(name.length() - length, length, suffix) == 0;
+    }
+
+    // FileInfo::temporary appends ".<process>-<counter>.part" to the name of the file
+    auto inline is_temporary(const std::string& name) -> bool
+    {
+      if (!ends_with(name, ".part")) return false;
+      auto end = name.length() - std::strlen(".part");
+      auto dot = name.rfind('.', end - 1);
+      if (dot == std::string::npos) return false;
+      auto dash = name.find('-', dot);
+      if (dash == std::string::npos || dash == dot + 1 || dash + 1 == end) return false;
+      auto is_digit = [](char symbol) { return symbol >= '0' && symbol <= '9'; };
+      return std::all_of(name.begin() + dot + 1, name.begin() + dash, is_digit) &&
+             std::all_of(name.begin() + dash + 1, name.begin() + end, is_digit);
+    }
+
+    // the files of the library itself: the states at the root with their partial saves,
+    // the temporary files of unfinished downloads and the validators beside downloaded files
+    auto inline is_kept(const std::string& name, const strings_t& files, bool is_root) -> bool
+    {
+      if (is_root)
+      {
+        for (auto file : { state_file, listing_file })
+        {
+          if (name.compare(0, std::strlen(file), file) != 0) continue;
+          auto suffix = name.substr(std::strlen(file));
+          if (suffix.empty() || suffix == ".part") return true;
+        }
+      }
+      if (is_temporary(name)) return true;
+      if (!ends_with(name, ".etag")) return false;
+      auto file = name.substr(0, name.length() - std::strlen(".etag"));
+      return std::find(files.begin(), files.end(), file) != files.end();
+    }
+
+    auto remove_scanned(
+      const std::string& local_directory,
+      const std::string& path,
+      const states_t& local,
+      bool& is_changed
+    ) -> bool
+    {
+      auto local_path = local_directory + "/" + path;
+      strings_t files;
+      strings_t subdirectories;
+      if (!FileInfo::list(local_path, files, subdirectories)) return false;
+
+      bool is_emptied = true;
+      for (const auto& name : files)
+      {
+        auto scanned = find(local, path + "/" + name);
+        State state{ false, std::string{}, 0, 0 };
+        if (!FileInfo::status(local_path + "/" + name, state.size, state.modified)) return false;
+        if (scanned == nullptr || is_changed_locally(state, *scanned))
+        {
+          is_changed = true;
+          is_emptied = false;
+          continue;
+        }
+        if (std::remove((local_path + "/" + name).c_str()) != 0) return false;
+      }
+      for (const auto& name : subdirectories)
+      {
+        auto scanned = find(local, path + "/" + name);
+        if (scanned == nullptr || !scanned->is_directory)
+        {
+          is_changed = true;
+          is_emptied = false;
+          continue;
+        }
+        if (remove_scanned(local_directory, path + "/" + name, local, is_changed)) continue;
+        if (!is_changed) return false;
+        is_emptied = false;
+      }
+      if (!is_emptied) return false;
+
+      // an entry which is not listed, like a link to a directory, is not removed
+      if (FileInfo::remove(local_path)) return true;
+      is_changed = true;
+      return false;
+    }
+
+    auto scan(const std::string& local_directory, states_t& local) -> bool
+    {
+      // a directory which does not exist yet is empty
+      unsigned long long size;
+      long long modified;
+      if (!FileInfo::status(local_directory, size, modified)) return true;
+
+      std::deque<std::string> directories{ std::string{} };
+      while (!directories.empty())
+      {
+        auto directory = std::move(directories.front());
+        directories.pop_front();
+
+        auto local_path = directory.empty() ? local_directory : local_directory + "/" + directory;
+        strings_t files;
+        strings_t subdirectories;
+        if (!FileInfo::list(local_path, files, subdirectories)) return false;
+
+        auto prefix = directory.empty() ? directory : directory + "/";
+        for (const auto& name : files)
+        {
+          if (is_kept(name, files, directory.empty())) continue;
+          State state{ false, std::string{}, 0, 0 };
+          if (!FileInfo::status(local_path + "/" + name, state.size, state.modified)) return false;
+          local[prefix + name] = state;
+        }
+        for (const auto& name : subdirectories)
+        {
+          local[prefix + name] = State{ true, std::string{}, 0, 0 };
+          directories.push_back(prefix + name);
+        }
+      }
+      return true;
+    }
+  } // namespace Sync
+} // namespace WebDAV
@@ -0,0 +1,144 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_SYNC_HPP
+#define WEBDAV_SYNC_HPP
+
+#include <webdav/client.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace WebDAV
+{
+  namespace Sync
+  {
+    ///
+    /// The separator precedes all other symbols,
+    /// so the items of a directory follow it at once
+    ///
+    struct Less
+    {
+      auto operator()(const std::string& lhs, const std::string& rhs) const -> bool;
+    };
+
+    ///
+    /// A file or a directory as it is seen on one side or as it was synchronized last time:
+    /// the ETag is remote, the size and the modification time are local
+    ///
+    struct State
+    {
+      bool is_directory;
+      std::string etag;
+      unsigned long long size;
+      long long modified;
+    };
+
+    ///
+    /// States by paths relative to the synchronized directory
+    ///
+    using states_t = std::map<std::string, State, Less>;
+    using actions_t = std::vector<SyncAction>;
+
+    ///
+    /// Everything a synchronization works with, the actions are performed concurrently,
+    /// each one writes only its own result
+    ///
+    struct Session
+    {
+      std::string remote_directory;
+      std::string local_directory;
+      states_t local;
+      states_t remote;
+      states_t base;
+      actions_t* actions;
+      std::vector<size_t> indexes;
+      std::vector<State> results;
+    };
+
+    ///
+    /// Names of the files in the local directory which keep the states of the last synchronization
+    /// and the last listing of the remote directory with the token of its changes
+    ///
+    extern const char* const state_file;
+    extern const char* const listing_file;
+
+    auto is_below(const std::string& path, const std::string& directory) -> bool;
+
+    ///
+    /// Reads the states kept in the local directory for the origin,
+    /// the states are empty if there are none or they belong to another origin
+    ///
+    auto load(
+      const std::string& local_directory,
+      const char* name,
+      const std::string& origin,
+      states_t& states,
+      std::string& token
+    ) -> void;
+    auto save(
+      const std::string& local_directory,
+      const char* name,
+      const std::string& origin,
+      const states_t& states,
+      const std::string& token
+    ) -> bool;
+
+    ///
+    /// Walks the local directory, a missing directory is empty. The files of the library are skipped:
+    /// the states, the temporary files of downloads and the .etag validators beside downloaded files
+    ///
+    auto scan(const std::string& local_directory, states_t& local) -> bool;
+
+    ///
+    /// Removes a local directory only as it was scanned: an entry which is new or has changed
+    /// since the scan is kept with the directories above it and marks the removal as changed
+    ///
+    auto remove_scanned(
+      const std::string& local_directory,
+      const std::string& path,
+      const states_t& local,
+      bool& is_changed
+    ) -> bool;
+
+    ///
+    /// Compares both sides with the last synchronization: a side which differs from it has changed,
+    /// the change is carried to the other side; changes on both sides are conflicts.
+    /// A removed file and a new file with the same content on the same side make a move.
+    /// Files of the same size on both sides without a record are compared by their content
+    ///
+    auto plan(const states_t& local, const states_t& remote, const states_t& base) -> actions_t;
+
+    ///
+    /// Sums up the sizes, the requests and the conflicts of the actions of the plan
+    ///
+    auto estimate(SyncPlan& plan) -> void;
+
+    ///
+    /// States of the last synchronization after the actions are performed
+    ///
+    auto update(const Session& session) -> states_t;
+  } // namespace Sync
+} // namespace WebDAV
+
+#endif
@@ -0,0 +1,170 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "tree.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace WebDAV
+{
+  const size_t TreeItem::none;
+
+  Tree::Tree(items_t items_, tree_progress_t progress) :
+    items(std::move(items_)),
+    reporter(std::move(progress)),
+    children(items.size()),
+    files_count(0),
+    remaining(items.size()),
+    is_failed(false),
+    bytes_now(0),
+    files_done(0),
+    files_failed(0),
+    is_cancelled(false)
+  {
+    for (size_t index = 0; index < this->items.size(); ++index)
+    {
+      const auto& item = this->items[index];
+      if (!item.is_directory) ++this->files_count;
+      if (item.parent == TreeItem::none) this->ready.push_back(index);
+      else this->children[item.parent].push_back(index);
+    }
+  }
+
+  auto Tree::run(size_t parallelism, const task_t& task) -> bool
+  {
+    // the calling thread is one of the workers
+    auto count = std::min(std::max<size_t>(parallelism, 1), this->items.size());
+    std::vector<std::thread> workers;
+    for (size_t index = 1; index < count; ++index)
+    {
+      workers.emplace_back(&Tree::work, this, std::cref(task));
+    }
+    this->work(task);
+    for (auto& worker : workers)
+    {
+      worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return !this->is_failed && !this->is_cancelled;
+  }
+
+  auto Tree::work(const task_t& task) -> void
+  {
+    Connection connection(&this->share);
+    for (;;)
+    {
+      size_t index;
+      {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        // an idle worker waits for the items of a parent in progress
+        this->condition.wait(lock, [this]()
+        {
+          return !this->ready.empty() || this->remaining == 0 || this->is_cancelled;
+        });
+        if (this->ready.empty() || this->is_cancelled) break;
+        index = this->ready.front();
+        this->ready.pop_front();
+      }
+
+      TreeTransfer transfer{ this, &this->items[index], index, 0, &connection };
+      bool is_done = task(transfer);
+      this->completed(index, transfer, is_done);
+    }
+    this->condition.notify_all();
+  }
+
+  auto Tree::is_reported() const -> bool
+  {
+    return this->reporter != nullptr;
+  }
+
+  int Tree::progress(void* context, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+  {
+    auto& transfer = *reinterpret_cast<TreeTransfer*>(context);
+    auto& self = *transfer.tree;
+    if (self.is_cancelled) return 1;
+
+    // a transfer either downloads or uploads, the other pair stays zero
+    auto now = static_cast<unsigned long long>(dlnow + ulnow);
+    auto total = static_cast<unsigned long long>(dltotal + ultotal);
+    if (now == transfer.now) return 0;
+
+    std::lock_guard<std::mutex> lock(self.mutex);
+    self.bytes_now += now - transfer.now;
+    transfer.now = now;
+    self.report(transfer, now, total);
+    return self.is_cancelled ? 1 : 0;
+  }
+
+  auto Tree::completed(size_t index, TreeTransfer& transfer, bool is_done) -> void
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      --this->remaining;
+      if (!is_done) this->is_failed = true;
+
+      if (is_done)
+      {
+        for (auto child : this->children[index])
+        {
+          this->ready.push_back(child);
+        }
+      }
+      else
+      {
+        for (auto child : this->children[index])
+        {
+          this->skip(child);
+        }
+      }
+
+      if (!transfer.item->is_directory)
+      {
+        if (is_done) ++this->files_done;
+        else ++this->files_failed;
+        this->report(transfer, transfer.now, transfer.now);
+      }
+    }
+    this->condition.notify_all();
+  }
+
+  auto Tree::skip(size_t index) -> void
+  {
+    --this->remaining;
+    if (!this->items[index].is_directory) ++this->files_failed;
+    for (auto child : this->children[index])
+    {
+      this->skip(child);
+    }
+  }
+
+  auto Tree::report(const TreeTransfer& transfer, unsigned long long now, unsigned long long total) -> void
+  {
+    if (!this->is_reported() || this->is_cancelled) return;
+
+    TreeProgress progress{ transfer.item->remote, now, total, this->bytes_now,
+                           this->files_done, this->files_failed, this->files_count };
+    if (!this->reporter(progress)) this->is_cancelled = true;
+  }
+} // namespace WebDAV
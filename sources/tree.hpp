@@ -0,0 +1,136 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#ifndef WEBDAV_TREE_HPP
+#define WEBDAV_TREE_HPP
+
+#include "share.hpp"
+
+#include <webdav/client.hpp>
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WebDAV
+{
+  class Tree;
+
+  ///
+  /// A file or a directory of a tree. An item with a parent is transferred
+  /// only after its parent, usually the directory which contains it.
+  ///
+  struct TreeItem
+  {
+    static const size_t none = static_cast<size_t>(-1);
+
+    TreeItem(std::string remote_, std::string local_, bool is_directory_ = false, size_t parent_ = none) :
+      remote(std::move(remote_)), local(std::move(local_)), is_directory(is_directory_), parent(parent_)
+    {
+    }
+
+    std::string remote;
+    std::string local;
+    bool is_directory;
+    size_t parent;
+  };
+
+  ///
+  /// Progress of the transfer of one file of a tree
+  ///
+  struct TreeTransfer
+  {
+    Tree* tree;
+    const TreeItem* item;
+    size_t index;
+    unsigned long long now;
+    const Connection* connection;  ///< kept by the worker for all its items
+  };
+
+  ///
+  /// Transfers files of a directory tree by a number of threads.
+  /// An item is started as soon as its parent is done, the items
+  /// of a failed parent fail without being started.
+  /// Every worker keeps its own connection, DNS lookups and TLS sessions
+  /// are shared by the requests of all threads, see Share.
+  /// Progress of every file is reported with the totals of the tree,
+  /// calls of the progress function are serialized.
+  ///
+  class Tree
+  {
+  public:
+    using items_t = std::vector<TreeItem>;
+    using task_t = std::function<bool(TreeTransfer& transfer)>;
+
+    Tree(items_t items, tree_progress_t progress);
+
+    Tree(const Tree& other) = delete;
+    auto operator=(const Tree& other) -> Tree& = delete;
+
+    ///
+    /// Runs the task for every item, stops early once the transfer is cancelled.
+    /// Parents must precede their items.
+    /// \return true if the task succeeded for all items
+    ///
+    auto run(size_t parallelism, const task_t& task) -> bool;
+
+    auto is_reported() const -> bool;
+
+    ///
+    /// Progress function of the requests, its context is a TreeTransfer.
+    /// It aborts the transfer once the progress function of the tree returns false
+    ///
+    static int progress(void* transfer, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+
+    Share share;
+
+  private:
+    auto work(const task_t& task) -> void;
+    auto completed(size_t index, TreeTransfer& transfer, bool is_done) -> void;
+    auto skip(size_t index) -> void;
+    auto report(const TreeTransfer& transfer, unsigned long long now, unsigned long long total) -> void;
+
+    const items_t items;
+    const tree_progress_t reporter;
+    std::vector<std::vector<size_t>> children;
+    size_t files_count;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<size_t> ready;
+    size_t remaining;
+    bool is_failed;
+    unsigned long long bytes_now;
+    size_t files_done;
+    size_t files_failed;
+
+    std::atomic<bool> is_cancelled;
+  };
+} // namespace WebDAV
+
+#endif
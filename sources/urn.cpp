@@ -20,18 +20,14 @@
 #
 ############################################################################*/
 
-#include <curl/curl.h>
-
-#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <iterator>
 #include <string>
-#include <vector>
 
 using std::string;
-using std::vector;
 
 #include "urn.hpp"
+#include "percent.hpp"
 
 namespace WebDAV
 {
@@ -41,128 +37,118 @@ namespace WebDAV
     const string Path::separate = "/";
     const string Path::root = "/";
 
-    Path::Path(const string& path_, bool force_dir)
+    auto Path::normalize(const char* path, size_t length, string& output) -> void
     {
-      string path = path_;
-      if (path_.empty()) path = Path::root;
-      auto first_position = path.find(Path::separate);
-      if (first_position != 0) path = Path::root + path;
-
-      auto last_symbol_index = path.length() - 1;
-      auto last_symbol = path.substr(last_symbol_index, 1);
-      auto is_dir = last_symbol == Path::separate;
-
-      if (force_dir && !is_dir) path += Path::separate;
-      m_path = path;
-
-      auto double_separte = Path::separate + Path::separate;
-      bool is_find = false;
-      do
+      // a single pass copies the runs between repeated separators
+      auto end = path + length;
+      auto start = path;
+      while (start != end)
       {
-        auto first_position = m_path.find(double_separte);
-        is_find = first_position != m_path.npos;
-        if (is_find)
+        if (*start == '/')
         {
-          m_path.replace(first_position, double_separte.size(), Path::separate);
+          if (output.empty() || output.back() != '/') output.push_back('/');
+          ++start;
+          continue;
         }
+        auto separator = static_cast<const char*>(std::memchr(start, '/', end - start));
+        auto finish = separator == nullptr ? end : separator + 1;
+        output.append(start, finish - start);
+        start = finish;
       }
-      while (is_find);
     }
 
-    Path::Path(std::nullptr_t)
+    auto hash_of(string_view key) -> size_t
     {
-      m_path = nullptr;
+      // FNV-1a
+      size_t hash = static_cast<size_t>(14695981039346656037ULL);
+      for (auto symbol : key)
+      {
+        hash ^= static_cast<unsigned char>(symbol);
+        hash *= static_cast<size_t>(1099511628211ULL);
+      }
+      return hash;
     }
 
-    auto Path::path() const -> string
+    Path::Path(string_view path_, bool force_dir)
     {
-      return m_path;
+      m_path.reserve(path_.length() + 2);
+      m_path.append(Path::root);
+      Path::normalize(path_.data(), path_.length(), m_path);
+      if (force_dir && m_path.back() != '/') m_path.append(Path::separate);
+      m_hash = hash_of(this->key());
     }
 
-    auto escape(void* request, const string& name) -> string
+    Path::Path(string&& normalized_path, std::nullptr_t) : m_path(std::move(normalized_path))
     {
-      string path = curl_easy_escape(request, name.c_str(), static_cast<int>(name.length()));
-      return path;
+      m_hash = hash_of(this->key());
     }
 
-    auto split(const string& text, const string& delims) -> vector<string>
+    Path::Path(std::nullptr_t) : m_hash(0)
     {
-      vector<string> tokens;
-      auto start = text.find_first_not_of(delims);
-      auto end = text.npos;
+    }
 
-      while ((end = text.find_first_of(delims, start)) != text.npos)
-      {
-        tokens.push_back(text.substr(start, end - start));
-        start = text.find_first_not_of(delims, end);
-      }
-      if (start != text.npos)
-      {
-        tokens.push_back(text.substr(start));
-      }
-      return tokens;
+    auto Path::path() const -> const string&
+    {
+      return m_path;
     }
 
-    auto Path::quote(void* request) const -> string
+    auto Path::length() const -> size_t
     {
-      if (this->is_root()) return m_path;
+      return m_path.length();
+    }
 
-      auto names = split(m_path, Path::separate);
+    auto Path::quote() const -> string
+    {
       string quote_path;
+      this->quote(quote_path);
+      return quote_path;
+    }
 
-      std::for_each(names.begin(), names.end(), [&quote_path, request](string & name)
-      {
-        auto escape_name = escape(request, name);
-        quote_path.append(Path::separate);
-        quote_path.append(escape_name);
-      });
+    auto Path::quote(string& output) const -> void
+    {
+      // the path is normalized, so it is encoded as a whole, separators included
+      Percent::encode(m_path.data(), m_path.length(), output);
+    }
 
-      if (is_directory())
-      {
-        quote_path.append(Path::separate);
-      }
-      return quote_path;
+    auto Path::key() const -> string_view
+    {
+      string_view path(m_path);
+      if (path.length() > 1 && path.back() == '/') path.remove_suffix(1);
+      return path;
     }
 
-    auto Path::name() const -> string
+    auto Path::hash() const -> size_t
     {
-      auto path = this->path();
-      auto is_root = path == Path::separate;
-      if (is_root) return string{""};
+      return m_hash;
+    }
 
-      if (this->is_directory())
-      {
-        auto path_without_slash = path.substr(0, path.length() - 1);
-        auto pre_last_separate_position = path_without_slash.rfind(Path::separate);
-        auto name = path.substr(pre_last_separate_position + 1);
-        return name;
-      }
-      else
-      {
-        auto last_separate_position = path.rfind(Path::separate);
-        auto name = path.substr(last_separate_position + 1);
-        return name;
-      }
+    auto Path::name_view() const -> string_view
+    {
+      if (this->is_root()) return string_view{};
+      auto key = this->key();
+      auto last_separate_position = key.rfind('/');
+      return key.substr(last_separate_position + 1);
     }
 
-    auto Path::parent() const -> Path
+    auto Path::name() const -> string
     {
-      if (this->is_root()) return Path{m_path};
+      auto name = this->name_view();
+      // the name of a directory keeps its trailing separator
+      if (this->is_directory() && !this->is_root()) return string(name.data(), name.length() + 1);
+      return string(name.data(), name.length());
+    }
 
-      auto last_separate_position = m_path.rfind(Path::separate, m_path.length() - 2);
-      if (last_separate_position == 0) return Path{Path::separate};
+    auto Path::parent() const -> Path
+    {
+      if (this->is_root()) return Path{ string(m_path), nullptr };
 
-      auto parent = m_path.substr(0, last_separate_position + 1);
-      return Path{parent};
+      auto last_separate_position = this->key().rfind('/');
+      return Path{ m_path.substr(0, last_separate_position + 1), nullptr };
     }
 
     auto Path::is_directory() const -> bool
     {
-      auto path = this->path();
-      auto last_symbol_index = path.length() - 1;
-      auto last_symbol = path.substr(last_symbol_index, 1);
-      auto is_equal = last_symbol == Path::separate;
-      return is_equal;
+      return !m_path.empty() && m_path.back() == '/';
     }
 
     auto Path::is_root() const -> bool
@@ -172,35 +158,16 @@ namespace WebDAV
 
     auto Path::operator+(const string& rhs) const -> Path
     {
-      return Path{ m_path + rhs };
+      string path;
+      path.reserve(m_path.length() + rhs.length() + 1);
+      path.append(m_path.empty() ? Path::root : m_path);
+      Path::normalize(rhs.data(), rhs.length(), path);
+      return Path{ std::move(path), nullptr };
     }
 
     auto Path::operator==(const Path& rhs) const -> bool
     {
-      if (this->is_root() && rhs.is_root()) return true;
-      if (!this->is_root() && rhs.is_root()) return false;
-
-      string lhs_path;
-      bool is_dir = is_directory();
-      if (is_dir)
-      {
-        lhs_path = m_path.substr(0, m_path.length() - 1);
-      }
-      else
-      {
-        lhs_path = m_path;
-      }
-      string rhs_path;
-      if (rhs.is_directory())
-      {
-        rhs_path = rhs.path();
-        rhs_path = rhs_path.substr(0, rhs_path.length() - 1);
-      }
-      else
-      {
-        rhs_path = rhs.path();
-      }
-      return lhs_path == rhs_path;
+      return m_hash == rhs.m_hash && this->key() == rhs.key();
     }
   } // namespace Urn
 } // namespace WebDAV
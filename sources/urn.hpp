@@ -23,6 +23,8 @@
 #ifndef WEBDAV_URN_HPP
 #define WEBDAV_URN_HPP
 
+#include <boost/utility/string_view.hpp>
+
 #include <cstddef>
 #include <iostream>
 #include <string>
@@ -33,12 +35,18 @@ namespace WebDAV
   {
     using std::string;
     using std::nullptr_t;
+    using string_view = boost::string_view;
 
+    ///
+    /// Normalized remote path: it starts with a separator and has no empty
+    /// names. A directory path ends with a separator. The hash of the path
+    /// is computed once, paths equal regardless of the trailing separator.
+    ///
     class Path
     {
     public:
 
-      explicit Path(const string& path_, bool force_dir = false);
+      explicit Path(string_view path_, bool force_dir = false);
       explicit Path(nullptr_t);
 
       auto operator+(const std::string& rhs) const -> Path;
@@ -48,12 +56,34 @@ namespace WebDAV
       auto is_root() const -> bool;
       auto name() const -> string;
       auto parent() const -> Path;
-      auto path() const -> string;
-      auto quote(void* request) const -> string;
+      auto path() const -> const string&;
+      auto length() const -> size_t;
+      auto quote() const -> string;
+      auto quote(string& output) const -> void;
+
+      ///
+      /// The path without the trailing separator, the root stays as is
+      ///
+      auto key() const -> string_view;
+      auto name_view() const -> string_view;
+      auto hash() const -> size_t;
+
+      struct Hash
+      {
+        auto operator()(const Path& path) const -> size_t
+        {
+          return path.hash();
+        }
+      };
 
     private:
 
+      Path(string&& normalized_path, nullptr_t);
+
+      static auto normalize(const char* path, size_t length, string& output) -> void;
+
       string m_path;
+      size_t m_hash;
 
       static const string separate;
       static const string root;
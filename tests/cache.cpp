@@ -0,0 +1,257 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include <webdav/client.hpp>
+
+#include "fixture.hpp"
+#include "server.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+SCENARIO("Client with a metadata cache must see its own changes", "[cache]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto dirname = fixture::get_dir_name();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(dirname);
+  CAPTURE(filename);
+
+  options["cache_ttl"] = "60000";
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A listed remote directory")
+  {
+    std::string directory = dirname;
+    std::string file = directory + filename;
+
+    REQUIRE(client->create_directory(directory));
+    REQUIRE(client->list(directory).empty());
+
+    WHEN("Upload a file into the directory")
+    {
+      auto is_success = client->upload_from(file, (char*)content.c_str(), content.length());
+      REQUIRE(is_success);
+
+      THEN("The file is listed and checked")
+      {
+        auto resources = client->list(directory);
+        CHECK(std::find(resources.begin(), resources.end(), filename) != resources.end());
+        CHECK(client->check(file));
+      }
+    }
+
+    WHEN("Clean the directory")
+    {
+      REQUIRE(client->check(directory));
+
+      auto is_success = client->clean(directory);
+
+      THEN("The directory is not existed")
+      {
+        CHECK(is_success);
+        CHECK_FALSE(client->check(directory));
+      }
+    }
+
+    client->clean(directory);
+  }
+}
+
+SCENARIO("Client with a negative cache must see its own uploads", "[cache][negative]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(filename);
+
+  options["negative_cache_ttl"] = "60000";
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("Not an existing remote file")
+  {
+    std::string remote_file = filename;
+
+    REQUIRE(client->clean(remote_file));
+    REQUIRE_FALSE(client->check(remote_file));
+
+    WHEN("Upload the file")
+    {
+      auto is_success = client->upload_from(remote_file, (char*)content.c_str(), content.length());
+
+      THEN("The file is existed")
+      {
+        CHECK(is_success);
+        CHECK(client->check(remote_file));
+      }
+    }
+
+    client->clean(remote_file);
+  }
+}
+
+SCENARIO("Client must share one request among concurrent identical calls", "[cache][flight]")
+{
+  fixture::Server server([](const fixture::Server::Request & request)
+  {
+    if (request.method != "PROPFIND") return fixture::Server::Response{ 405, "" };
+    // the answer is delayed, so that every caller arrives while the request is in flight
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    return fixture::Server::Response{ 207,
+      "<?xml version=\"1.0\" encoding=\"utf-8\"?><d:multistatus xmlns:d=\"DAV:\">"
+      "<d:response><d:href>/file</d:href><d:propstat><d:prop><d:resourcetype/>"
+      "<d:getcontentlength>42</d:getcontentlength></d:prop>"
+      "<d:status>HTTP/1.1 200 OK</d:status></d:propstat></d:response></d:multistatus>" };
+  });
+
+  dict_t options =
+  {
+    {"webdav_hostname", server.url()},
+    {"webdav_username", "username"},
+    {"webdav_password", "password"}
+  };
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A remote file")
+  {
+    WHEN("Request its information by several threads at once")
+    {
+      std::vector<dict_t> informations(8);
+      std::vector<std::thread> threads;
+      for (auto& information : informations)
+      {
+        threads.emplace_back([&client, &information]()
+        {
+          information = client->info("file");
+        });
+      }
+      for (auto& thread : threads) thread.join();
+
+      THEN("The server must receive one request and every caller must get its result")
+      {
+        CHECK(server.requests().size() == 1);
+        for (const auto& information : informations)
+        {
+          CHECK_FALSE(information.empty());
+          CHECK(information == informations.front());
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Client must prefetch small listed files within the capacity", "[cache][prefetch]")
+{
+  const std::string small_content = "small";
+  const std::string large_content(50, 'l');
+
+  fixture::Server server([&](const fixture::Server::Request & request)
+  {
+    auto resource = [](const std::string & href, const std::string & etag, size_t size)
+    {
+      return "<d:response><d:href>" + href + "</d:href><d:propstat><d:prop>" +
+             (etag.empty() ? "<d:resourcetype><d:collection/></d:resourcetype>" : "<d:resourcetype/><d:getetag>" + etag + "</d:getetag>") +
+             "<d:getcontentlength>" + std::to_string(size) + "</d:getcontentlength>"
+             "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat></d:response>";
+    };
+
+    if (request.method == "PROPFIND")
+    {
+      // the large file is listed first, so it is prefetched, if at all, before the small one
+      return fixture::Server::Response{ 207,
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?><d:multistatus xmlns:d=\"DAV:\">" +
+        resource("/dir/", "", 0) + resource("/dir/large", "\"large\"", large_content.size()) +
+        resource("/dir/small", "\"small\"", small_content.size()) +
+        "</d:multistatus>" };
+    }
+    if (request.method != "GET") return fixture::Server::Response{ 405, "" };
+    if (request.target == "/dir/small") return fixture::Server::Response{ 200, small_content, { "ETag: \"small\"" } };
+    if (request.target == "/dir/large") return fixture::Server::Response{ 200, large_content, { "ETag: \"large\"" } };
+    return fixture::Server::Response{ 404, "" };
+  });
+
+  dict_t options =
+  {
+    {"webdav_hostname", server.url()},
+    {"webdav_username", "username"},
+    {"webdav_password", "password"},
+    {"cache_ttl", "60000"},
+    {"prefetch_count", "4"},
+    {"prefetch_size_limit", "1000"},
+    {"prefetch_capacity", "10"}
+  };
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  auto count_gets = [&](const std::string & target)
+  {
+    auto requests = server.requests();
+    return std::count_if(requests.begin(), requests.end(), [&target](const fixture::Server::Request & request)
+    {
+      return request.method == "GET" && request.target == target;
+    });
+  };
+
+  GIVEN("A listed directory with a file which fits into the capacity and a file which does not")
+  {
+    auto resources = client->list("dir/");
+    REQUIRE(resources.size() == 2);
+
+    // the prefetcher downloads in the background, the small file is the last one
+    for (auto attempt = 0; attempt < 100 && count_gets("/dir/small") == 0; ++attempt)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    WHEN("Download both files")
+    {
+      auto large_gets_before = count_gets("/dir/large");
+
+      std::string small_buffer;
+      auto is_small_downloaded = client->download_to("dir/small", small_buffer);
+      std::string large_buffer;
+      auto is_large_downloaded = client->download_to("dir/large", large_buffer);
+
+      THEN("The small file must come from the prefetch and the large one from its own request")
+      {
+        CHECK(is_small_downloaded);
+        CHECK(small_buffer == small_content);
+        CHECK(count_gets("/dir/small") == 1);
+
+        CHECK(is_large_downloaded);
+        CHECK(large_buffer == large_content);
+        CHECK(large_gets_before == 0);
+        CHECK(count_gets("/dir/large") == 1);
+      }
+    }
+  }
+}
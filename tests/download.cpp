@@ -23,11 +23,18 @@
 #include <webdav/client.hpp>
 
 #include "fixture.hpp"
+#include "server.hpp"
 
 #include <catch.hpp>
 
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 SCENARIO("Client must download into buffer", "[download][buffer]")
 {
@@ -104,3 +111,401 @@ SCENARIO("Client must download stream", "[download][stream]")
     }
   }
 }
+
+SCENARIO("Client must download a file only if it is modified", "[download][conditional]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(filename);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A downloaded remote file")
+  {
+    std::string remote_resource = filename;
+    std::string local_file = filename;
+
+    auto is_success = client->upload_from(remote_resource, (char*)content.c_str(), content.length());
+    REQUIRE(is_success);
+
+    WHEN("Download the file twice")
+    {
+      dict_t validators;
+      REQUIRE(client->download_if_modified(remote_resource, local_file, validators));
+      auto first_validators = validators;
+
+      auto is_success = client->download_if_modified(remote_resource, local_file, validators);
+
+      THEN("The file is up to date")
+      {
+        CHECK(is_success);
+        CHECK(validators == first_validators);
+
+        std::ifstream stream(local_file, std::ios::binary);
+        std::string local_content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        CHECK(local_content == content);
+      }
+    }
+
+    client->clean(remote_resource);
+  }
+}
+
+SCENARIO("Client must read a part of a remote file", "[download][range]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(filename);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("An opened remote file")
+  {
+    std::string remote_resource = filename;
+
+    auto is_success = client->upload_from(remote_resource, (char*)content.c_str(), content.length());
+    REQUIRE(is_success);
+
+    auto file = client->open(remote_resource, 8, 4);
+    REQUIRE(file.is_open());
+    REQUIRE(file.size() == content.length());
+
+    WHEN("Read the middle and the tail of the file")
+    {
+      std::string middle(20, '\0');
+      auto middle_size = file.pread(&middle[0], middle.length(), 5);
+
+      std::string tail(10, '\0');
+      auto tail_size = file.pread(&tail[0], tail.length(), content.length() - 4);
+
+      THEN("The parts match the content")
+      {
+        CHECK(middle_size == 20);
+        CHECK(middle == content.substr(5, 20));
+        CHECK(tail_size == 4);
+        CHECK(tail.substr(0, 4) == content.substr(content.length() - 4));
+      }
+    }
+
+    WHEN("Read more blocks than the cache holds")
+    {
+      std::string whole(content.length(), '\0');
+      auto whole_size = file.pread(&whole[0], whole.length(), 0);
+
+      std::string middle(40, '\0');
+      auto middle_size = file.pread(&middle[0], middle.length(), 3);
+
+      THEN("The parts match the content")
+      {
+        REQUIRE(content.length() > 8 * 4);
+        CHECK(whole_size == static_cast<long long>(content.length()));
+        CHECK(whole == content);
+        CHECK(middle_size == 40);
+        CHECK(middle == content.substr(3, 40));
+      }
+    }
+
+    client->clean(remote_resource);
+  }
+}
+
+SCENARIO("Client must stream a remote file through a small buffer", "[download][stream]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(filename);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("An uploaded file")
+  {
+    std::string remote_resource = filename;
+
+    auto is_success = client->upload_from(remote_resource, (char*)content.c_str(), content.length());
+    REQUIRE(is_success);
+
+    WHEN("Read the file through a stream")
+    {
+      auto stream = client->open_stream(remote_resource, 16);
+      std::string streamed_content{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+
+      THEN("The streamed content matches the content")
+      {
+        CHECK_FALSE(stream.bad());
+        CHECK(streamed_content == content);
+      }
+    }
+
+    WHEN("Read a missing file through a stream buffer")
+    {
+      auto stream = client->open_stream(remote_resource + ".missing", 16);
+      std::string streamed_content{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+
+      THEN("The stream must end and report the failure")
+      {
+        CHECK(streamed_content.empty());
+        CHECK(stream.bad());
+        CHECK(stream.status() == 404);
+      }
+    }
+
+    client->clean(remote_resource);
+  }
+}
+
+SCENARIO("Client must download into a buffer of the caller", "[download][buffer][capacity]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(filename);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("An uploaded file")
+  {
+    std::string remote_resource = filename;
+
+    auto is_success = client->upload_from(remote_resource, (char*)content.c_str(), content.length());
+    REQUIRE(is_success);
+
+    WHEN("Download into a buffer large enough")
+    {
+      std::vector<char> buffer(content.length() + 10);
+      unsigned long long buffer_size = 0;
+      auto is_downloaded = client->download_into(remote_resource, buffer.data(), buffer.size(), buffer_size);
+
+      THEN("The buffer must contain the content")
+      {
+        CHECK(is_downloaded);
+        CHECK(std::string(buffer.data(), buffer_size) == content);
+      }
+    }
+
+    WHEN("Download into a too small buffer")
+    {
+      std::vector<char> buffer(content.length() / 2);
+      unsigned long long buffer_size = 0;
+      auto is_downloaded = client->download_into(remote_resource, buffer.data(), buffer.size(), buffer_size);
+
+      THEN("The download must fail")
+      {
+        CHECK_FALSE(is_downloaded);
+      }
+    }
+
+    WHEN("Download into a vector and a string")
+    {
+      std::vector<char> vector_buffer{ 'x' };
+      std::string string_buffer = "x";
+      auto is_vector_downloaded = client->download_to(remote_resource, vector_buffer);
+      auto is_string_downloaded = client->download_to(remote_resource, string_buffer);
+
+      THEN("The containers must contain only the content")
+      {
+        CHECK(is_vector_downloaded);
+        CHECK(is_string_downloaded);
+        CHECK(std::string(vector_buffer.begin(), vector_buffer.end()) == content);
+        CHECK(string_buffer == content);
+      }
+    }
+
+    client->clean(remote_resource);
+  }
+}
+
+SCENARIO("Client must download a directory tree", "[download][tree]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto dirname = fixture::get_dir_name();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(dirname);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A remote directory with a subdirectory")
+  {
+    std::string directory = dirname;
+    std::string subdirectory = directory + "nested/";
+    REQUIRE(client->create_directory(subdirectory, true));
+
+    for (auto remote_file : { directory + filename, subdirectory + filename, subdirectory + "second" })
+    {
+      REQUIRE(client->upload_from(remote_file, (char*)content.c_str(), content.length()));
+    }
+
+    // a sibling named like a partial download must not be mixed with the file
+    auto other_content = std::string(content.rbegin(), content.rend());
+    REQUIRE(client->upload_from(subdirectory + filename + ".part", (char*)other_content.c_str(), other_content.length()));
+
+    auto local_directory = dirname.substr(0, dirname.length() - 1);
+
+    WHEN("Download the directory by two threads")
+    {
+      WebDAV::TreeProgress last_progress{};
+      auto is_downloaded = client->download_tree(directory, local_directory, 2, [&](const WebDAV::TreeProgress & progress)
+      {
+        last_progress = progress;
+        return true;
+      });
+
+      THEN("All files must be downloaded")
+      {
+        CHECK(is_downloaded);
+        CHECK(last_progress.files_done == 4);
+        CHECK(last_progress.files_count == 4);
+        CHECK(last_progress.bytes_now == 4 * content.length());
+
+        for (auto local_file : { local_directory + "/" + filename, local_directory + "/nested/" + filename, local_directory + "/nested/second" })
+        {
+          std::ifstream stream(local_file, std::ios::binary);
+          std::string local_content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+          CHECK(local_content == content);
+        }
+
+        std::ifstream stream(local_directory + "/nested/" + filename + ".part", std::ios::binary);
+        std::string local_content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        CHECK(local_content == other_content);
+      }
+    }
+
+    boost::filesystem::remove_all(local_directory);
+    client->clean(directory);
+  }
+}
+
+SCENARIO("Client must fail to download a tree with a directory which cannot be listed", "[download][tree][failure]")
+{
+  fixture::Server server([](const fixture::Server::Request & request)
+  {
+    auto resource = [](const std::string & href, bool is_directory)
+    {
+      return "<d:response><d:href>" + href + "</d:href><d:propstat><d:prop><d:resourcetype>" +
+             (is_directory ? "<d:collection/>" : "") + "</d:resourcetype>"
+             "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat></d:response>";
+    };
+
+    if (request.method != "PROPFIND") return fixture::Server::Response{ 405, "" };
+    if (request.target == "/dir/broken/") return fixture::Server::Response{ 500, "" };
+    return fixture::Server::Response{ 207,
+      "<?xml version=\"1.0\" encoding=\"utf-8\"?><d:multistatus xmlns:d=\"DAV:\">" +
+      resource("/dir/", true) + resource("/dir/broken/", true) +
+      "</d:multistatus>" };
+  });
+
+  dict_t options =
+  {
+    {"webdav_hostname", server.url()},
+    {"webdav_username", "username"},
+    {"webdav_password", "password"}
+  };
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A remote directory whose subdirectory answers with a server error")
+  {
+    auto local_directory = fixture::get_dir_name();
+    local_directory.pop_back();
+
+    WHEN("Download the directory")
+    {
+      auto is_downloaded = client->download_tree("dir/", local_directory);
+
+      THEN("The download must fail")
+      {
+        CHECK_FALSE(is_downloaded);
+      }
+    }
+
+    boost::filesystem::remove_all(local_directory);
+  }
+}
+
+SCENARIO("Client must read a remote file from a server without range support", "[download][range][whole]")
+{
+  std::string content;
+  for (auto index = 0; index < 100; ++index) content.push_back(static_cast<char>('a' + index % 26));
+
+  fixture::Server server([&](const fixture::Server::Request & request)
+  {
+    if (request.method != "HEAD" && request.method != "GET") return fixture::Server::Response{ 405, "" };
+    return fixture::Server::Response{ 200, content };
+  });
+
+  dict_t options =
+  {
+    {"webdav_hostname", server.url()},
+    {"webdav_username", "username"},
+    {"webdav_password", "password"}
+  };
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  auto count_gets = [&]()
+  {
+    auto requests = server.requests();
+    return std::count_if(requests.begin(), requests.end(), [](const fixture::Server::Request & request)
+    {
+      return request.method == "GET";
+    });
+  };
+
+  GIVEN("A remote file which fits into the cache")
+  {
+    auto file = client->open("file", 8, 16);
+    REQUIRE(file.is_open());
+    REQUIRE(file.size() == content.length());
+
+    WHEN("Read several distant parts of the file")
+    {
+      std::string head(10, '\0');
+      auto head_size = file.pread(&head[0], head.length(), 5);
+
+      std::string middle(10, '\0');
+      auto middle_size = file.pread(&middle[0], middle.length(), 60);
+
+      std::string tail(10, '\0');
+      auto tail_size = file.pread(&tail[0], tail.length(), 90);
+
+      THEN("The parts match the content and the file is downloaded once")
+      {
+        CHECK(head_size == 10);
+        CHECK(head == content.substr(5, 10));
+        CHECK(middle_size == 10);
+        CHECK(middle == content.substr(60, 10));
+        CHECK(tail_size == 10);
+        CHECK(tail == content.substr(90, 10));
+        CHECK(count_gets() == 1);
+      }
+    }
+  }
+
+  GIVEN("A remote file which does not fit into the cache")
+  {
+    auto file = client->open("file", 8, 4);
+    REQUIRE(file.is_open());
+
+    WHEN("Read two parts of the file")
+    {
+      std::string head(10, '\0');
+      auto head_size = file.pread(&head[0], head.length(), 5);
+
+      std::string middle(10, '\0');
+      auto middle_size = file.pread(&middle[0], middle.length(), 60);
+
+      THEN("The reads fail and the file is not downloaded again")
+      {
+        CHECK(head_size == -1);
+        CHECK(middle_size == -1);
+        CHECK(count_gets() == 1);
+      }
+    }
+  }
+}
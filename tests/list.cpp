@@ -23,6 +23,7 @@
 #include <webdav/client.hpp>
 
 #include "fixture.hpp"
+#include "server.hpp"
 
 #include <catch.hpp>
 
@@ -126,3 +127,181 @@ SCENARIO("Client can list an empty remote directory", "[list][empty]")
     }
   }
 }
+
+SCENARIO("Client must list the changes of a remote directory", "[list][changes]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto dirname = fixture::get_dir_name();
+
+  CAPTURE(dirname);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A remote directory with a file and a directory")
+  {
+    REQUIRE(client->create_directory(dirname + "dir/", true));
+    REQUIRE(client->upload_from(dirname + "file", (char*)content.c_str(), content.length()));
+
+    std::string sync_token;
+    std::map<std::string, dict_t> changed;
+    WebDAV::strings_t removed;
+    auto is_reported = client->changes(dirname, sync_token, changed, removed);
+    if (!is_reported) WARN("The server does not report changes");
+
+    WHEN("List the changes without a token")
+    {
+      THEN("All resources must be listed with a token")
+      {
+        if (is_reported)
+        {
+          CHECK_FALSE(sync_token.empty());
+          CHECK(changed.size() == 2);
+          CHECK(changed.count("dir/") == 1);
+          CHECK(changed["file"]["size"] == std::to_string(content.length()));
+          CHECK(removed.empty());
+        }
+      }
+    }
+
+    WHEN("Change the directory and list the changes with the token")
+    {
+      REQUIRE(client->upload_from(dirname + "dir/added", (char*)content.c_str(), content.length()));
+      REQUIRE(client->clean(dirname + "file"));
+
+      is_reported = is_reported && client->changes(dirname, sync_token, changed, removed);
+
+      THEN("Only the changed resources must be listed")
+      {
+        if (is_reported)
+        {
+          CHECK(changed.count("dir/added") == 1);
+          CHECK(changed.count("file") == 0);
+          CHECK(removed == WebDAV::strings_t{ "file" });
+        }
+      }
+    }
+
+    client->clean(dirname);
+  }
+}
+
+SCENARIO("Client must parse the changes reported by a server", "[list][changes][report]")
+{
+  // the first report is truncated, the next one ends it, a later token has expired
+  fixture::Server server([](const fixture::Server::Request & request)
+  {
+    static const std::string head =
+      "<?xml version=\"1.0\" encoding=\"utf-8\"?><d:multistatus xmlns:d=\"DAV:\">";
+    auto file = [](const std::string & href, const std::string & etag, const std::string & size)
+    {
+      return "<d:response><d:href>" + href + "</d:href><d:propstat><d:prop>"
+             "<d:resourcetype/><d:getetag>" + etag + "</d:getetag>"
+             "<d:getcontentlength>" + size + "</d:getcontentlength>"
+             "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat></d:response>";
+    };
+
+    if (request.method != "REPORT") return fixture::Server::Response{ 405, "" };
+    if (request.body.find("<D:sync-token></D:sync-token>") != std::string::npos)
+    {
+      return fixture::Server::Response{ 207, head +
+        "<d:response><d:href>/dir/</d:href><d:status>HTTP/1.1 507 Insufficient Storage</d:status></d:response>" +
+        file("/dir/file", "\"e1\"", "10") +
+        "<d:response><d:href>/dir/sub/</d:href><d:propstat><d:prop>"
+        "<d:resourcetype><d:collection/></d:resourcetype>"
+        "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat></d:response>"
+        "<d:sync-token>http://example.com/sync/1</d:sync-token></d:multistatus>" };
+    }
+    if (request.body.find("http://example.com/sync/1") != std::string::npos)
+    {
+      return fixture::Server::Response{ 207, head +
+        file("/dir/sub/added%20file", "\"e2\"", "20") +
+        "<d:response><d:href>/dir/gone</d:href><d:status>HTTP/1.1 404 Not Found</d:status></d:response>"
+        "<d:sync-token>http://example.com/sync/2</d:sync-token></d:multistatus>" };
+    }
+    return fixture::Server::Response{ 403, head +
+      "<d:response><d:href>/dir/</d:href><d:status>HTTP/1.1 403 Forbidden</d:status></d:response></d:multistatus>" };
+  });
+
+  dict_t options =
+  {
+    {"webdav_hostname", server.url()},
+    {"webdav_username", "username"},
+    {"webdav_password", "password"}
+  };
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A directory listed without a token")
+  {
+    std::string sync_token;
+    std::map<std::string, dict_t> changed;
+    WebDAV::strings_t removed;
+    auto is_reported = client->changes("dir/", sync_token, changed, removed);
+
+    THEN("The truncated report must be continued and every member listed")
+    {
+      CHECK(is_reported);
+      CHECK(server.requests().size() == 2);
+      CHECK(sync_token == "http://example.com/sync/2");
+      CHECK(changed.size() == 3);
+      CHECK(changed["file"]["etag"] == "\"e1\"");
+      CHECK(changed["file"]["size"] == "10");
+      CHECK(changed.count("sub/") == 1);
+      CHECK(changed["sub/added file"]["size"] == "20");
+      CHECK(removed == WebDAV::strings_t{ "gone" });
+    }
+
+    WHEN("List the changes with an expired token")
+    {
+      auto is_reported_again = client->changes("dir/", sync_token, changed, removed);
+
+      THEN("The report must fail and the token must be dropped")
+      {
+        CHECK_FALSE(is_reported_again);
+        CHECK(sync_token.empty());
+        CHECK(server.requests().back().body.find("http://example.com/sync/2") != std::string::npos);
+      }
+    }
+  }
+}
+
+SCENARIO("Client must list resources whose names are not UTF-8", "[list][href]")
+{
+  fixture::Server server([](const fixture::Server::Request & request)
+  {
+    auto resource = [](const std::string & href, bool is_directory)
+    {
+      return "<d:response><d:href>" + href + "</d:href><d:propstat><d:prop><d:resourcetype>" +
+             (is_directory ? "<d:collection/>" : "") + "</d:resourcetype>"
+             "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat></d:response>";
+    };
+
+    if (request.method != "PROPFIND") return fixture::Server::Response{ 405, "" };
+    return fixture::Server::Response{ 207,
+      "<?xml version=\"1.0\" encoding=\"utf-8\"?><d:multistatus xmlns:d=\"DAV:\">" +
+      resource("/dir/", true) + resource("/dir/caf%E9", false) + resource("/dir/caf%C3%A9", false) +
+      resource("/dir/caf%00", false) +
+      "</d:multistatus>" };
+  });
+
+  dict_t options =
+  {
+    {"webdav_hostname", server.url()},
+    {"webdav_username", "username"},
+    {"webdav_password", "password"}
+  };
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A directory with a Latin-1 name, a UTF-8 name and a name with a NUL byte")
+  {
+    WHEN("List the directory")
+    {
+      auto resources = client->list("dir/");
+
+      THEN("The names without a NUL byte must be listed with their bytes")
+      {
+        CHECK(resources == WebDAV::strings_t({ "caf\xE9", "caf\xC3\xA9" }));
+      }
+    }
+  }
+}
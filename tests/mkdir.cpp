@@ -0,0 +1,128 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include <webdav/client.hpp>
+
+#include "fixture.hpp"
+
+#include <catch.hpp>
+
+#include <memory>
+
+SCENARIO("Client must create a deep remote directory", "[mkdir]")
+{
+  auto options = fixture::get_options();
+  auto dirname = fixture::get_dir_name();
+
+  CAPTURE(dirname);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A path of missing directories")
+  {
+    std::string directory = dirname + "a/b/c/d/";
+
+    WHEN("Create the directory recursively")
+    {
+      auto is_created = client->create_directory(directory, true);
+
+      THEN("All directories of the path must exist")
+      {
+        CHECK(is_created);
+        CHECK(client->is_directory(dirname + "a/b/"));
+        CHECK(client->is_directory(directory));
+      }
+    }
+
+    WHEN("Create the directory without its parents")
+    {
+      auto is_created = client->create_directory(directory);
+
+      THEN("The directory must not be created")
+      {
+        CHECK_FALSE(is_created);
+        CHECK_FALSE(client->check(directory));
+      }
+    }
+
+    client->clean(dirname);
+  }
+
+  GIVEN("A created directory removed by another client")
+  {
+    REQUIRE(client->create_directory(dirname + "a/b/", true));
+
+    std::unique_ptr<WebDAV::Client> other{ new WebDAV::Client{ options } };
+    REQUIRE(other->clean(dirname));
+
+    WHEN("Create the removed directory again")
+    {
+      auto is_created = client->create_directory(dirname + "a/b/", true);
+
+      THEN("The directory must exist")
+      {
+        CHECK(is_created);
+        CHECK(client->is_directory(dirname + "a/b/"));
+      }
+    }
+
+    client->clean(dirname);
+  }
+
+  GIVEN("A client remembering the directories it created")
+  {
+    auto remembering_options = options;
+    remembering_options["directory_cache_ttl"] = "60000";
+    std::unique_ptr<WebDAV::Client> remembering{ new WebDAV::Client{ remembering_options } };
+
+    REQUIRE(remembering->create_directory(dirname + "a/b/", true));
+
+    WHEN("Another client removes the directories and a subdirectory is created")
+    {
+      std::unique_ptr<WebDAV::Client> other{ new WebDAV::Client{ options } };
+      REQUIRE(other->clean(dirname));
+
+      auto is_created = remembering->create_directory(dirname + "a/b/c/", true);
+
+      THEN("The removed directories must be created again")
+      {
+        CHECK(is_created);
+        CHECK(client->is_directory(dirname + "a/b/c/"));
+      }
+    }
+
+    WHEN("The same client removes the parent and creates the directory again")
+    {
+      REQUIRE(remembering->clean(dirname + "a/"));
+
+      auto is_created = remembering->create_directory(dirname + "a/b/", true);
+
+      THEN("The whole removed subtree must be forgotten")
+      {
+        CHECK(is_created);
+        CHECK(client->is_directory(dirname + "a/b/"));
+      }
+    }
+
+    client->clean(dirname);
+  }
+}
@@ -0,0 +1,136 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include "server.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+namespace fixture
+{
+  using boost::asio::ip::tcp;
+
+  Server::Server(handler_t handler_) :
+    handler(std::move(handler_)),
+    acceptor(context, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+    port(acceptor.local_endpoint().port()),
+    is_stopped(false)
+  {
+    this->thread = std::thread([this] { this->serve(); });
+  }
+
+  Server::~Server()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->is_stopped = true;
+    }
+
+    // a connection wakes up the server waiting for the next one
+    boost::system::error_code error;
+    tcp::socket socket(this->context);
+    socket.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), this->port), error);
+    this->thread.join();
+  }
+
+  auto Server::url() const -> std::string
+  {
+    return "http://127.0.0.1:" + std::to_string(this->port);
+  }
+
+  auto Server::requests() -> std::vector<Request>
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->received;
+  }
+
+  auto Server::serve() -> void
+  {
+    for (;;)
+    {
+      tcp::socket socket(this->context);
+      boost::system::error_code error;
+      this->acceptor.accept(socket, error);
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->is_stopped) return;
+      }
+      if (error) continue;
+
+      // the requests of a kept alive connection are answered in turn
+      while (this->answer(socket));
+    }
+  }
+
+  auto Server::answer(tcp::socket& socket) -> bool
+  {
+    boost::asio::streambuf input;
+    boost::system::error_code error;
+    auto header_size = boost::asio::read_until(socket, input, "\r\n\r\n", error);
+    if (error) return false;
+
+    Request request;
+    std::string head(boost::asio::buffers_begin(input.data()), boost::asio::buffers_begin(input.data()) + header_size);
+    input.consume(header_size);
+
+    std::istringstream lines(head);
+    std::string line;
+    std::getline(lines, line);
+    std::istringstream request_line(line);
+    request_line >> request.method >> request.target;
+
+    size_t content_length = 0;
+    while (std::getline(lines, line))
+    {
+      auto colon = line.find(':');
+      if (colon == std::string::npos) continue;
+      auto name = line.substr(0, colon);
+      for (auto& symbol : name) symbol = static_cast<char>(std::tolower(symbol));
+      if (name == "content-length") content_length = std::strtoul(line.c_str() + colon + 1, nullptr, 10);
+    }
+
+    if (input.size() < content_length)
+    {
+      boost::asio::read(socket, input, boost::asio::transfer_exactly(content_length - input.size()), error);
+      if (error) return false;
+    }
+    request.body.assign(boost::asio::buffers_begin(input.data()), boost::asio::buffers_begin(input.data()) + content_length);
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->received.push_back(request);
+    }
+
+    auto response = this->handler(request);
+    std::string output =
+      "HTTP/1.1 " + std::to_string(response.status) + " Status\r\n"
+      "Content-Type: application/xml; charset=utf-8\r\n"
+      "Content-Length: " + std::to_string(response.body.length()) + "\r\n";
+    for (const auto& header : response.headers) output += header + "\r\n";
+    output += "\r\n";
+    // the answer to HEAD has the length of the body, but not the body itself
+    if (request.method != "HEAD") output += response.body;
+    boost::asio::write(socket, boost::asio::buffer(output), error);
+    return !error;
+  }
+}
@@ -0,0 +1,80 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+namespace fixture
+{
+  ///
+  /// HTTP server on the loopback which answers every request by a handler,
+  /// it stands in for responses a test server cannot be relied on to give
+  ///
+  class Server
+  {
+  public:
+    struct Request
+    {
+      std::string method;
+      std::string target;
+      std::string body;
+    };
+
+    struct Response
+    {
+      int status;
+      std::string body;
+      std::vector<std::string> headers;  ///< extra header lines as "Name: value"
+    };
+
+    using handler_t = std::function<Response(const Request& request)>;
+
+    explicit Server(handler_t handler);
+    ~Server();
+
+    Server(const Server& other) = delete;
+    auto operator=(const Server& other) -> Server& = delete;
+
+    auto url() const -> std::string;
+    auto requests() -> std::vector<Request>;
+
+  private:
+    auto serve() -> void;
+    auto answer(boost::asio::ip::tcp::socket& socket) -> bool;
+
+    const handler_t handler;
+
+    boost::asio::io_context context;
+    boost::asio::ip::tcp::acceptor acceptor;
+    unsigned short port;
+    bool is_stopped;
+
+    std::mutex mutex;
+    std::vector<Request> received;
+    std::thread thread;
+  };
+}
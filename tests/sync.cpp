@@ -0,0 +1,329 @@
+/*#***************************************************************************
+#                         __    __   _____       _____
+#   Project              |  |  |  | |     \     /  ___|
+#                        |  |__|  | |  |\  \   /  /
+#                        |        | |  | )  ) (  (
+#                        |   /\   | |  |/  /   \  \___
+#                         \_/  \_/  |_____/     \_____|
+#
+# Copyright (C) 2018, The WDC Project, <rusdevops@gmail.com>, et al.
+#
+# This software is licensed as described in the file LICENSE, which
+# you should have received as part of this distribution.
+#
+# You may opt to use, copy, modify, merge, publish, distribute and/or sell
+# copies of the Software, and permit persons to whom the Software is
+# furnished to do so, under the terms of the LICENSE file.
+#
+# This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+# KIND, either express or implied.
+#
+############################################################################*/
+
+#include <webdav/client.hpp>
+
+#include "fixture.hpp"
+
+#include <catch.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+static auto count(const WebDAV::SyncPlan& plan, WebDAV::SyncAction::Kind kind) -> size_t
+{
+  return std::count_if(plan.actions.begin(), plan.actions.end(), [kind](const WebDAV::SyncAction & action)
+  {
+    return action.kind == kind;
+  });
+}
+
+static auto write(const std::string& local_file, const std::string& content) -> void
+{
+  std::ofstream out(local_file, std::ios::binary);
+  out << content;
+}
+
+SCENARIO("Client must synchronize a remote and a local directory", "[sync]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_file_content();
+  auto dirname = fixture::get_dir_name();
+
+  CAPTURE(dirname);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A local file and a remote file in nested directories")
+  {
+    auto local_directory = dirname.substr(0, dirname.length() - 1);
+    std::string remote_directory = dirname + "remote/";
+    boost::filesystem::create_directories(local_directory + "/local");
+    write(local_directory + "/local/file.txt", content);
+    REQUIRE(client->create_directory(remote_directory + "remote/", true));
+    REQUIRE(client->upload_from(remote_directory + "remote/file.txt", const_cast<char*>(content.data()), content.size()));
+
+    WHEN("Plan the synchronization")
+    {
+      WebDAV::SyncPlan plan;
+      auto is_planned = client->sync(remote_directory, local_directory, plan, true);
+
+      THEN("Every side must get what the other one has, nothing is changed yet")
+      {
+        CHECK(is_planned);
+        CHECK(count(plan, WebDAV::SyncAction::create_remote_directory) == 1);
+        CHECK(count(plan, WebDAV::SyncAction::create_local_directory) == 1);
+        CHECK(plan.upload_size == content.size());
+        CHECK(plan.download_size == content.size());
+        CHECK(plan.requests == 3);
+        CHECK(plan.scan_requests >= 1);
+        CHECK(plan.scan_requests <= 3);
+        CHECK_FALSE(client->check(remote_directory + "local/"));
+        CHECK_FALSE(boost::filesystem::exists(local_directory + "/remote"));
+      }
+    }
+
+    WHEN("Plan the synchronization with files left by downloads")
+    {
+      write(local_directory + "/local/file.txt.etag", "ETag: \"1\"\n");
+      write(local_directory + "/local/file.txt.1234-5.part", content);
+      write(local_directory + "/notes.etag", content);
+
+      WebDAV::SyncPlan plan;
+      auto is_planned = client->sync(remote_directory, local_directory, plan, true);
+
+      THEN("The temporary files and the validators must not be uploaded")
+      {
+        CHECK(is_planned);
+        CHECK(count(plan, WebDAV::SyncAction::upload) == 2);
+        CHECK(std::none_of(plan.actions.begin(), plan.actions.end(), [](const WebDAV::SyncAction & action)
+        {
+          return action.path == "local/file.txt.etag" || action.path == "local/file.txt.1234-5.part";
+        }));
+      }
+    }
+
+    WHEN("Synchronize the directories twice")
+    {
+      WebDAV::SyncPlan plan;
+      auto is_synchronized = client->sync(remote_directory, local_directory, plan);
+      WebDAV::SyncPlan next_plan;
+      auto is_synchronized_again = client->sync(remote_directory, local_directory, next_plan);
+
+      THEN("Both sides must have both files, nothing is left to do after that")
+      {
+        CHECK(is_synchronized);
+        CHECK(std::all_of(plan.actions.begin(), plan.actions.end(), [](const WebDAV::SyncAction & action)
+        {
+          return action.is_done;
+        }));
+
+        std::string remote_content;
+        CHECK(client->download_to(remote_directory + "local/file.txt", remote_content));
+        CHECK(remote_content == content);
+        CHECK(boost::filesystem::file_size(local_directory + "/remote/file.txt") == content.size());
+
+        CHECK(is_synchronized_again);
+        CHECK(next_plan.actions.empty());
+        CHECK(next_plan.requests == 0);
+      }
+    }
+
+    WHEN("Change the synchronized directories on both sides")
+    {
+      WebDAV::SyncPlan plan;
+      REQUIRE(client->sync(remote_directory, local_directory, plan));
+
+      write(local_directory + "/local/file.txt", content + content);
+      boost::filesystem::rename(local_directory + "/remote/file.txt", local_directory + "/remote/moved.txt");
+      REQUIRE(client->clean(remote_directory + "local/"));
+      REQUIRE(client->upload_from(remote_directory + "added.txt", const_cast<char*>(content.data()), content.size()));
+
+      WebDAV::SyncPlan next_plan;
+      auto is_synchronized = client->sync(remote_directory, local_directory, next_plan);
+
+      THEN("A removal of a changed directory must be a conflict, the rest must be carried over")
+      {
+        CHECK_FALSE(is_synchronized);
+        CHECK(next_plan.conflicts == 1);
+        CHECK(count(next_plan, WebDAV::SyncAction::move_remote) == 1);
+        CHECK(count(next_plan, WebDAV::SyncAction::download) == 1);
+        CHECK(count(next_plan, WebDAV::SyncAction::upload) == 0);
+
+        CHECK(client->check(remote_directory + "remote/moved.txt"));
+        CHECK_FALSE(client->check(remote_directory + "remote/file.txt"));
+        CHECK(boost::filesystem::exists(local_directory + "/added.txt"));
+        CHECK(boost::filesystem::file_size(local_directory + "/local/file.txt") == 2 * content.size());
+      }
+    }
+
+    WHEN("Change the same file on both sides")
+    {
+      WebDAV::SyncPlan plan;
+      REQUIRE(client->sync(remote_directory, local_directory, plan));
+
+      write(local_directory + "/remote/file.txt", content + content);
+      auto remote_content = content + content + content;
+      REQUIRE(client->upload_from(remote_directory + "remote/file.txt",
+                                  const_cast<char*>(remote_content.data()), remote_content.size()));
+
+      WebDAV::SyncPlan next_plan;
+      auto is_synchronized = client->sync(remote_directory, local_directory, next_plan);
+
+      THEN("The file must be a conflict and stay as it is on both sides")
+      {
+        CHECK_FALSE(is_synchronized);
+        REQUIRE(next_plan.actions.size() == 1);
+        CHECK(next_plan.actions.front().kind == WebDAV::SyncAction::conflict);
+        CHECK(next_plan.actions.front().path == "remote/file.txt");
+        CHECK(boost::filesystem::file_size(local_directory + "/remote/file.txt") == 2 * content.size());
+        CHECK(client->info(remote_directory + "remote/file.txt")["size"] == std::to_string(remote_content.size()));
+      }
+    }
+
+    WHEN("Add a file to a local directory while its removal is carried over")
+    {
+      WebDAV::SyncPlan plan;
+      REQUIRE(client->sync(remote_directory, local_directory, plan));
+
+      REQUIRE(client->clean(remote_directory + "remote/"));
+      REQUIRE(client->upload_from(remote_directory + "added.txt", const_cast<char*>(content.data()), content.size()));
+
+      // the download of added.txt goes before the removal of the directory
+      bool is_added = false;
+      auto add = [&is_added, &local_directory, &content](const WebDAV::TreeProgress&)
+      {
+        if (!is_added) write(local_directory + "/remote/new.txt", content);
+        is_added = true;
+        return true;
+      };
+
+      WebDAV::SyncPlan next_plan;
+      auto is_synchronized = client->sync(remote_directory, local_directory, next_plan, false, 1, add);
+
+      THEN("The new file must be kept and the removal must be a conflict")
+      {
+        CHECK(is_added);
+        CHECK_FALSE(is_synchronized);
+        CHECK(next_plan.conflicts == 1);
+        CHECK(boost::filesystem::exists(local_directory + "/remote/new.txt"));
+        CHECK_FALSE(boost::filesystem::exists(local_directory + "/remote/file.txt"));
+        CHECK(boost::filesystem::exists(local_directory + "/added.txt"));
+      }
+    }
+
+    boost::filesystem::remove_all(local_directory);
+    client->clean(dirname);
+  }
+
+  GIVEN("Files on both sides which were never synchronized")
+  {
+    auto local_directory = dirname.substr(0, dirname.length() - 1);
+    std::string remote_directory = dirname + "remote/";
+    auto other_content = std::string(content.rbegin(), content.rend());
+    boost::filesystem::create_directories(local_directory);
+    write(local_directory + "/same.txt", content);
+    write(local_directory + "/other.txt", content);
+    REQUIRE(client->create_directory(remote_directory, true));
+    REQUIRE(client->upload_from(remote_directory + "same.txt", const_cast<char*>(content.data()), content.size()));
+    REQUIRE(client->upload_from(remote_directory + "other.txt", const_cast<char*>(other_content.data()), other_content.size()));
+
+    WHEN("Synchronize the directories twice")
+    {
+      WebDAV::SyncPlan plan;
+      auto is_synchronized = client->sync(remote_directory, local_directory, plan);
+      WebDAV::SyncPlan next_plan;
+      auto is_synchronized_again = client->sync(remote_directory, local_directory, next_plan);
+
+      THEN("Files of the same size but another content must stay a conflict")
+      {
+        CHECK(count(plan, WebDAV::SyncAction::compare) == 1);
+        CHECK_FALSE(is_synchronized);
+        CHECK(plan.conflicts == 1);
+        CHECK_FALSE(is_synchronized_again);
+        REQUIRE(next_plan.actions.size() == 1);
+        CHECK(next_plan.actions.front().kind == WebDAV::SyncAction::conflict);
+        CHECK(next_plan.actions.front().path == "other.txt");
+
+        std::string remote_content;
+        CHECK(client->download_to(remote_directory + "other.txt", remote_content));
+        CHECK(remote_content == other_content);
+        std::ifstream local_stream(local_directory + "/other.txt", std::ios::binary);
+        CHECK(std::string(std::istreambuf_iterator<char>(local_stream), std::istreambuf_iterator<char>()) == content);
+      }
+    }
+
+    boost::filesystem::remove_all(local_directory);
+    client->clean(dirname);
+  }
+}
+
+SCENARIO("Client must not list unchanged remote directories again", "[sync][unchanged]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_file_content();
+  auto dirname = fixture::get_dir_name();
+
+  CAPTURE(dirname);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A synchronized tree of remote directories")
+  {
+    auto local_directory = dirname.substr(0, dirname.length() - 1);
+    std::string remote_directory = dirname + "remote/";
+    for (auto directory : { "a/b/c/", "d/" })
+    {
+      REQUIRE(client->create_directory(remote_directory + directory, true));
+      REQUIRE(client->upload_from(remote_directory + directory + "file.txt", const_cast<char*>(content.data()), content.size()));
+    }
+
+    WebDAV::SyncPlan plan;
+    REQUIRE(client->sync(remote_directory, local_directory, plan));
+
+    // a server which reports changes is scanned by one REPORT, otherwise
+    // the REPORT fails and every directory of the tree is listed
+    bool is_reported = plan.scan_requests == 1;
+    CAPTURE(is_reported);
+    if (!is_reported) REQUIRE(plan.scan_requests == 6);
+
+    WHEN("Synchronize the unchanged tree")
+    {
+      WebDAV::SyncPlan next_plan;
+      auto is_synchronized = client->sync(remote_directory, local_directory, next_plan);
+
+      THEN("Only the top directory must be listed")
+      {
+        CHECK(is_synchronized);
+        CHECK(next_plan.actions.empty());
+        CHECK(next_plan.scan_requests == (is_reported ? 1 : 2));
+      }
+    }
+
+    WHEN("Change a file deep in the tree")
+    {
+      auto changed_content = content + content;
+      REQUIRE(client->upload_from(remote_directory + "a/b/c/file.txt",
+                                  const_cast<char*>(changed_content.data()), changed_content.size()));
+
+      WebDAV::SyncPlan next_plan;
+      auto is_synchronized = client->sync(remote_directory, local_directory, next_plan);
+
+      THEN("Only the directories on the path of the change must be listed")
+      {
+        CHECK(is_synchronized);
+        CHECK(next_plan.scan_requests == (is_reported ? 1 : 5));
+        REQUIRE(next_plan.actions.size() == 1);
+        CHECK(next_plan.actions.front().kind == WebDAV::SyncAction::download);
+        CHECK(next_plan.actions.front().path == "a/b/c/file.txt");
+        CHECK(boost::filesystem::file_size(local_directory + "/a/b/c/file.txt") == changed_content.size());
+      }
+    }
+
+    boost::filesystem::remove_all(local_directory);
+    client->clean(dirname);
+  }
+}
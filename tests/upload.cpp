@@ -26,6 +26,9 @@
 
 #include <catch.hpp>
 
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <sstream>
@@ -128,3 +131,158 @@ SCENARIO("Client must upload file stream", "[upload][file][stream]")
     }
   }
 }
+
+SCENARIO("Client must report information of an uploaded file", "[upload][file][information]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_file_content();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(filename);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A local file")
+  {
+    std::ofstream out(filename);
+    out << content;
+    out.close();
+
+    std::string remote_resource = filename;
+
+    WHEN("Upload the file")
+    {
+      dict_t information;
+      auto is_success = client->upload(remote_resource, filename, information);
+
+      THEN("The size of the file is reported")
+      {
+        CHECK(is_success);
+        CHECK(information["size"] == std::to_string(content.length()));
+      }
+    }
+
+    client->clean(remote_resource);
+  }
+}
+
+SCENARIO("Client must upload through a writer", "[upload][writer]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(filename);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A content of an unknown size")
+  {
+    std::string remote_resource = filename;
+
+    WHEN("Write the content in small pieces")
+    {
+      REQUIRE(client->clean(remote_resource));
+
+      auto writer = client->open_writer(remote_resource, -1, 16);
+      for (size_t position = 0; position < content.length(); position += 5)
+      {
+        writer << content.substr(position, 5);
+      }
+      auto is_success = writer.close();
+
+      THEN("The content must be uploaded")
+      {
+        CHECK(is_success);
+        std::stringstream stream;
+        REQUIRE(client->download_to(remote_resource, stream));
+        CHECK(stream.str() == content);
+      }
+    }
+
+    client->clean(remote_resource);
+  }
+}
+
+SCENARIO("Client must upload segments", "[upload][segments]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_buff_content();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(filename);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A content split into segments")
+  {
+    std::string remote_resource = filename;
+
+    WebDAV::segments_t segments;
+    for (size_t position = 0; position < content.length(); position += 7)
+    {
+      segments.emplace_back(content.data() + position, std::min<size_t>(7, content.length() - position));
+    }
+
+    WHEN("Upload the segments")
+    {
+      REQUIRE(client->clean(remote_resource));
+
+      auto is_success = client->upload_from(remote_resource, segments);
+
+      THEN("The joined segments must be uploaded")
+      {
+        CHECK(is_success);
+        std::stringstream stream;
+        REQUIRE(client->download_to(remote_resource, stream));
+        CHECK(stream.str() == content);
+      }
+    }
+
+    client->clean(remote_resource);
+  }
+}
+
+SCENARIO("Client must upload a directory tree", "[upload][tree]")
+{
+  auto options = fixture::get_options();
+  auto content = fixture::get_file_content();
+  auto dirname = fixture::get_dir_name();
+  auto filename = fixture::get_file_name();
+
+  CAPTURE(dirname);
+
+  std::unique_ptr<WebDAV::Client> client{ new WebDAV::Client{ options } };
+
+  GIVEN("A local directory with a subdirectory")
+  {
+    auto local_directory = dirname.substr(0, dirname.length() - 1);
+    boost::filesystem::create_directories(local_directory + "/nested/deeper");
+
+    for (auto local_file : { local_directory + "/" + filename, local_directory + "/nested/deeper/" + filename })
+    {
+      std::ofstream out(local_file, std::ios::binary);
+      out << content;
+    }
+
+    std::string directory = dirname + "uploaded/";
+
+    WHEN("Upload the directory by two threads")
+    {
+      auto is_uploaded = client->upload_tree(directory, local_directory, 2);
+
+      THEN("The directories and files must be created")
+      {
+        CHECK(is_uploaded);
+        CHECK(client->is_directory(directory + "nested/deeper/"));
+
+        std::string remote_content;
+        CHECK(client->download_to(directory + "nested/deeper/" + filename, remote_content));
+        CHECK(remote_content == content);
+      }
+    }
+
+    boost::filesystem::remove_all(local_directory);
+    client->clean(dirname);
+  }
+}